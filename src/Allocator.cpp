@@ -16,93 +16,97 @@
 #include "node/Sigmoid.hpp"
 #include "node/Softmax.hpp"
 #include "node/Tanh.hpp"
+#include <new>
+#include <utility>
 
 Allocator::Allocator() = default;
 
+Allocator::~Allocator() {
+  for (auto node = nodes.rbegin(); node != nodes.rend(); ++node)
+    (*node)->~Node();
+}
+
+template <class T, class... Args>
+Node* Allocator::New(Args&&... args) {
+  // The node, then its tensors.
+  Arena::Scope scope(&arena);
+  void* memory = arena.Allocate(sizeof(T), alignof(T));
+  nodes.push_back(new (memory) T(std::forward<Args>(args)...));
+  return nodes.back();
+}
+
+void Allocator::AllocateTrainingBuffers() {
+  Arena::Scope scope(&arena);
+  for (Node* node : nodes)
+    node->AllocateTrainingBuffers();
+}
+
 Node* Allocator::BatchNormalization(Node* input) {
-  nodes.emplace_back(new ::BatchNormalization(input));
-  return nodes.back().get();
+  return New<::BatchNormalization>(input);
 }
 
 Node* Allocator::Bias(Node* input) {
-  nodes.emplace_back(new ::Bias(input));
-  return nodes.back().get();
+  return New<::Bias>(input);
 }
 
 Node* Allocator::BilinearUpsampling(Node* input) {
-  nodes.emplace_back(new ::BilinearUpsampling(input));
-  return nodes.back().get();
+  return New<::BilinearUpsampling>(input);
 }
 
 Node* Allocator::Convolution2D(Node* input,
                                const std::vector<size_t> filter_size,
                                size_t num_features,
                                size_t stride) {
-  nodes.emplace_back(
-      new ::Convolution2D(input, filter_size, num_features, stride));
-  return nodes.back().get();
+  return New<::Convolution2D>(input, filter_size, num_features, stride);
 }
 
 Node* Allocator::Deconvolution2D(Node* input,
                                  std::vector<size_t> filter_size,
                                  size_t num_filters,
                                  size_t stride) {
-  nodes.emplace_back(
-      new ::Deconvolution2D(input, filter_size, num_filters, stride));
-  return nodes.back().get();
+  return New<::Deconvolution2D>(input, filter_size, num_filters, stride);
 }
 
 Node* Allocator::Dropout(Node* input, float ratio) {
-  nodes.emplace_back(new ::Dropout(input, ratio));
-  return nodes.back().get();
+  return New<::Dropout>(input, ratio);
 }
 
-Node* Allocator::Input(const std::vector<size_t>& size) {
-  nodes.emplace_back(new ::Input(size));
-  return nodes.back().get();
+Node* Allocator::Input(const Shape& size, size_t capacity) {
+  return New<::Input>(size, capacity);
 }
 
 Node* Allocator::LeakyRelu(Node* input) {
-  nodes.emplace_back(new ::LeakyRelu(input));
-  return nodes.back().get();
+  return New<::LeakyRelu>(input);
 }
 
-Node* Allocator::Linear(Node* input, std::vector<size_t> output_sizes) {
-  nodes.emplace_back(new ::Linear(input, output_sizes));
-  return nodes.back().get();
+Node* Allocator::Linear(Node* input, const Shape& output_sizes) {
+  return New<::Linear>(input, output_sizes);
 }
 
 Node* Allocator::MaxPooling(Node* input) {
-  nodes.emplace_back(new ::MaxPooling(input));
-  return nodes.back().get();
+  return New<::MaxPooling>(input);
 }
 
 Node* Allocator::Relu(Node* input) {
-  nodes.emplace_back(new ::Relu(input));
-  return nodes.back().get();
+  return New<::Relu>(input);
 }
 
 Node* Allocator::Sigmoid(Node* input) {
-  nodes.emplace_back(new ::Sigmoid(input));
-  return nodes.back().get();
+  return New<::Sigmoid>(input);
 }
 
 Node* Allocator::Tanh(Node* input) {
-  nodes.emplace_back(new ::Tanh(input));
-  return nodes.back().get();
+  return New<::Tanh>(input);
 }
 
 Node* Allocator::Softmax(Node* input) {
-  nodes.emplace_back(new ::Softmax(input));
-  return nodes.back().get();
+  return New<::Softmax>(input);
 }
 
 Node* Allocator::Noise(Node* input, float sigma) {
-  nodes.emplace_back(new ::Noise(input, sigma));
-  return nodes.back().get();
+  return New<::Noise>(input, sigma);
 }
 
 Node* Allocator::Border(Node* input, size_t border_size, float value) {
-  nodes.emplace_back(new ::Border(input, border_size, value));
-  return nodes.back().get();
+  return New<::Border>(input, border_size, value);
 }
@@ -1,18 +1,37 @@
 #ifndef NODEALLOCATOR_H
 #define NODEALLOCATOR_H
 
+#include "Arena.hpp"
 #include "node/Node.hpp"
-#include <memory>
 
+// Builds the nodes of a network, and owns them.
+//
+// The nodes and their tensors are carved from one Arena, in the order they are
+// built: the network lives in a few large regions, and is released at once
+// with the Allocator. The nodes must not be resized (Model::SetBatchCapacity)
+// too often, as the memory they release is only reused once the Allocator is
+// gone.
 class Allocator {
  public:
   Allocator();
+  ~Allocator();
+  Allocator(const Allocator&) = delete;
+  Allocator& operator=(const Allocator&) = delete;
+
+  // Allocate the buffers only needed for training, for every node, in the
+  // order they were built, from the arena. Otherwise Model::Train() allocates
+  // them from the Pool. See Node::AllocateTrainingBuffers().
+  void AllocateTrainingBuffers();
+
+  // The memory of the network.
+  size_t Bytes() const { return arena.bytes(); }
+  size_t ReservedBytes() const { return arena.reserved(); }
 
   // Input
-  Node* Input(const std::vector<size_t>& size);
+  Node* Input(const Shape& size, size_t capacity = Node::T);
 
   // Linear
-  Node* Linear(Node* input, std::vector<size_t> output_sizes);
+  Node* Linear(Node* input, const Shape& output_sizes);
   Node* Bias(Node* input);
   Node* Convolution2D(Node* input,
                       const std::vector<size_t> filter_size,
@@ -45,7 +64,11 @@ class Allocator {
   Node* Border(Node* input, size_t border_size, float value);
 
  private:
-  std::vector<std::unique_ptr<Node>> nodes;
+  template <class T, class... Args>
+  Node* New(Args&&... args);
+
+  Arena arena;
+  std::vector<Node*> nodes;
 };
 
 #endif /* end of include guard: NODEALLOCATOR_H */
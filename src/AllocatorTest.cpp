@@ -0,0 +1,68 @@
+#include <cstdint>
+#include "gtest/gtest.h"
+
+#include "Allocator.hpp"
+#include "Arena.hpp"
+#include "Model.hpp"
+
+TEST(Allocator, Arena) {
+  Arena arena;
+  EXPECT_EQ(arena.bytes(), 0u);
+  EXPECT_EQ(arena.reserved(), 0u);
+
+  char* a = static_cast<char*>(arena.Allocate(10, 1));
+  char* b = static_cast<char*>(arena.Allocate(4, 64));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % Arena::region_size, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+  EXPECT_EQ(b, a + 64);
+  EXPECT_EQ(arena.bytes(), 68u);
+
+  // Too big for what is left of the region.
+  arena.Allocate(Arena::region_size, 64);
+  EXPECT_EQ(arena.regions(), 2u);
+  EXPECT_EQ(arena.reserved(), 2 * Arena::region_size);
+
+  // The Storage allocated within a Scope comes from the arena.
+  {
+    Arena::Scope scope(&arena);
+    Storage storage(16);
+    EXPECT_EQ(arena.regions(), 3u);
+    EXPECT_EQ(Arena::Current(), &arena);
+  }
+  EXPECT_EQ(Arena::Current(), nullptr);
+}
+
+TEST(Allocator, NodesInGraphOrder) {
+  Allocator allocator;
+  Node* input = allocator.Input({8}, 4);
+  Node* linear = allocator.Linear(input, {4});
+  Node* sigmoid = allocator.Sigmoid(linear);
+
+  // Every node is followed by its tensors.
+  auto address = [](const void* p) { return reinterpret_cast<uintptr_t>(p); };
+  EXPECT_LT(address(input), address(input->output.data()));
+  EXPECT_LT(address(input->output.data()), address(linear));
+  EXPECT_LT(address(linear), address(linear->params.values.data()));
+  EXPECT_LT(address(linear->output.data()), address(sigmoid));
+  EXPECT_LT(address(sigmoid), address(sigmoid->output.data()));
+
+  const size_t floats = 4 * 8 + 9 * 4 + 4 * 4 + 4 * 4;
+  EXPECT_GE(allocator.Bytes(), floats * sizeof(float));
+  EXPECT_EQ(allocator.ReservedBytes(), Arena::region_size);
+
+  // The training buffers follow.
+  const size_t bytes = allocator.Bytes();
+  allocator.AllocateTrainingBuffers();
+  EXPECT_GT(allocator.Bytes(), bytes);
+  EXPECT_LT(address(sigmoid->output.data()),
+            address(linear->input_sensitivity.data()));
+
+  // Training doesn't allocate them again.
+  std::vector<Example> examples = {{Tensor::Random({8}), Tensor::Random({4})}};
+  Model model(input, sigmoid, examples);
+  const float* params_data = linear->params.values.data();
+  const float* sensitivity = linear->input_sensitivity.data();
+  model.Train(0.01f, 8);
+  EXPECT_EQ(linear->params.values.data(), params_data);
+  EXPECT_EQ(linear->input_sensitivity.data(), sensitivity);
+}
@@ -0,0 +1,73 @@
+#include "Arena.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+thread_local Arena* current_arena = nullptr;
+
+size_t RoundUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+constexpr size_t Arena::region_size;
+
+Arena::~Arena() {
+  for (const Region& region : regions_)
+    std::free(region.raw);
+}
+
+void* Arena::Allocate(size_t bytes, size_t alignment) {
+  if (!regions_.empty()) {
+    const Region& region = regions_.back();
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(region.begin);
+    const size_t offset = RoundUp(begin + used_, alignment) - begin;
+    if (offset + bytes <= region.size) {
+      bytes_ += offset + bytes - used_;
+      used_ = offset + bytes;
+      return region.begin + offset;
+    }
+  }
+
+  // Start a new region. The block is at its beginning, so it is aligned.
+  const size_t size = RoundUp(bytes ? bytes : 1, region_size);
+  void* raw = std::malloc(size + region_size);
+  if (!raw)
+    throw std::bad_alloc();
+  char* begin = reinterpret_cast<char*>(
+      RoundUp(reinterpret_cast<uintptr_t>(raw), region_size));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  madvise(begin, size, MADV_HUGEPAGE);
+#endif
+  regions_.push_back({raw, begin, size});
+  used_ = bytes;
+  bytes_ += bytes;
+  return begin;
+}
+
+size_t Arena::reserved() const {
+  size_t reserved = 0;
+  for (const Region& region : regions_)
+    reserved += region.size;
+  return reserved;
+}
+
+Arena::Scope::Scope(Arena* arena) : previous(current_arena) {
+  current_arena = arena;
+}
+
+Arena::Scope::~Scope() {
+  current_arena = previous;
+}
+
+// static
+Arena* Arena::Current() {
+  return current_arena;
+}
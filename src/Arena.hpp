@@ -0,0 +1,58 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+
+// Memory carved one block after the other from a few large regions, and
+// released all at once with the Arena.
+//
+// The regions are aligned on, and sized in multiples of, 2 MiB, so that the
+// system can back them with huge pages. Freeing a single block does nothing:
+// its memory is only reused once the Arena is gone.
+class Arena {
+ public:
+  // Size and alignment of the regions.
+  static constexpr size_t region_size = size_t(2) << 20;
+
+  Arena() = default;
+  ~Arena();
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(size_t bytes, size_t alignment);
+
+  // Bytes handed out, alignment padding included.
+  size_t bytes() const { return bytes_; }
+  // Bytes of the regions.
+  size_t reserved() const;
+  size_t regions() const { return regions_.size(); }
+
+  // While a Scope is alive, the Storage allocated by its thread is carved from
+  // |arena|. See Allocator.
+  class Scope {
+   public:
+    explicit Scope(Arena* arena);
+    ~Scope();
+
+   private:
+    Arena* previous;
+  };
+
+  // The arena of the innermost Scope of this thread, or null.
+  static Arena* Current();
+
+ private:
+  struct Region {
+    void* raw;
+    char* begin;
+    size_t size;
+  };
+  std::vector<Region> regions_;
+  size_t used_ = 0;  // In the last region.
+  size_t bytes_ = 0;
+};
+
+#endif /* end of include guard: ARENA_H */
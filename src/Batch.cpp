@@ -0,0 +1,139 @@
+#include "Batch.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "kernel/Kernel.hpp"
+
+Batch::Batch(size_t capacity, const Shape& sizes)
+    : block(capacity * Multiply(sizes)), sample_size_(Multiply(sizes)) {
+  samples.reserve(capacity);
+  for (size_t i = 0; i < capacity; ++i)
+    samples.push_back(Tensor::View(sizes, block.data() + i * sample_size_));
+}
+
+// static
+Batch Batch::Wrap(float* data, size_t capacity, const Shape& sizes) {
+  Batch batch;
+  batch.sample_size_ = Multiply(sizes);
+  batch.block = Storage::View(data, capacity * batch.sample_size_);
+  batch.samples.reserve(capacity);
+  for (size_t i = 0; i < capacity; ++i)
+    batch.samples.push_back(Tensor::View(sizes, nullptr));
+  batch.Bind();
+  return batch;
+}
+
+Batch::Batch(const Batch& other) : Batch() {
+  *this = other;
+}
+
+Batch& Batch::operator=(const Batch& other) {
+  if (this == &other)
+    return *this;
+  block.Reset();
+  block = other.block;
+  packed = other.packed;
+  precision_ = other.precision_;
+  discarded_ = other.discarded_;
+  sample_size_ = other.sample_size_;
+  samples.clear();
+  samples.reserve(other.size());
+  for (size_t i = 0; i < other.size(); ++i)
+    samples.push_back(Tensor::View(other[i].sizes, nullptr));
+  Bind();
+  return *this;
+}
+
+Batch& Batch::operator=(Batch&& other) {
+  if (this == &other)
+    return *this;
+  // The block is replaced, even when it is an alias.
+  block.Reset();
+  block = std::move(other.block);
+  packed = std::move(other.packed);
+  precision_ = other.precision_;
+  discarded_ = other.discarded_;
+  sample_size_ = other.sample_size_;
+  samples = std::move(other.samples);
+  return *this;
+}
+
+TensorView Batch::View(size_t begin, size_t count) const {
+  TensorView view = samples[begin];
+  view.sizes.push_back(count);
+  view.strides.push_back(sample_size());
+  return view;
+}
+
+Batch Batch::Alias() {
+  Batch alias;
+  alias.block = Storage::View(block.data(), block.size());
+  alias.sample_size_ = sample_size_;
+  alias.samples.reserve(size());
+  for (const Tensor& sample : samples)
+    alias.samples.push_back(Tensor::View(sample.sizes, nullptr));
+  alias.Bind();
+  return alias;
+}
+
+void Batch::Fill(float value) {
+  std::fill(block.begin(), block.end(), value);
+}
+
+void Batch::Pack(Precision precision) {
+  if (precision == precision_)
+    return;
+  Unpack();
+  if (precision == Precision::Float32)
+    return;
+
+  const size_t size = block.size();
+  packed = Storage::Uninitialized((size + 1) / 2);
+  auto* output = reinterpret_cast<uint16_t*>(packed.data());
+  if (precision == Precision::BFloat16)
+    kernel::Get().ToBFloat16(block.data(), output, size);
+  else
+    kernel::Get().ToFloat16(block.data(), output, size);
+
+  precision_ = precision;
+  block.Reset();
+  Bind();
+}
+
+void Batch::Discard() {
+  block.Reset();
+  packed = Storage();
+  precision_ = Precision::Float32;
+  discarded_ = true;
+  Bind();
+}
+
+void Batch::Unpack() {
+  if (discarded_) {
+    block = Storage::Uninitialized(samples.size() * sample_size_);
+    discarded_ = false;
+    Bind();
+    return;
+  }
+  if (!IsPacked())
+    return;
+
+  const size_t size = samples.size() * sample_size_;
+  block = Storage::Uninitialized(size);
+  const auto* input = reinterpret_cast<const uint16_t*>(packed.data());
+  if (precision_ == Precision::BFloat16)
+    kernel::Get().FromBFloat16(input, block.data(), size);
+  else
+    kernel::Get().FromFloat16(input, block.data(), size);
+
+  precision_ = Precision::Float32;
+  packed = Storage();
+  Bind();
+}
+
+void Batch::Bind() {
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i].values.Rebind(block.empty() ? nullptr
+                                           : block.data() + i * sample_size_);
+  }
+}
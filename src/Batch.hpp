@@ -0,0 +1,86 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "Precision.hpp"
+#include "Tensor.hpp"
+#include "TensorView.hpp"
+
+// The per-sample buffers of a node (output, sensitivities, ...) for a batch.
+//
+// Every sample lives in one contiguous block, one after the other, so that a
+// kernel can process the whole batch as a [size() x sample_size()] matrix.
+// Each sample is also exposed as a Tensor viewing its own slice of the block.
+//
+// The block can be packed into a half-width Precision while its values are
+// only kept for later. The float block is then released, and the samples can't
+// be accessed until Unpack() is called. They keep their identity: pointers to
+// them stay valid.
+class Batch {
+ public:
+  Batch() = default;
+  Batch(size_t capacity, const Shape& sizes);
+
+  // A Batch using the memory [data, data + capacity * Multiply(sizes)), owned
+  // by someone else.
+  static Batch Wrap(float* data, size_t capacity, const Shape& sizes);
+
+  Batch(const Batch& other);
+  Batch(Batch&& other) = default;
+  Batch& operator=(const Batch& other);
+  Batch& operator=(Batch&& other);
+
+  // Per-sample access.
+  size_t size() const { return samples.size(); }
+  bool empty() const { return samples.empty(); }
+  Tensor& operator[](size_t i) { return samples[i]; }
+  const Tensor& operator[](size_t i) const { return samples[i]; }
+  std::vector<Tensor>::iterator begin() { return samples.begin(); }
+  std::vector<Tensor>::iterator end() { return samples.end(); }
+  std::vector<Tensor>::const_iterator begin() const { return samples.begin(); }
+  std::vector<Tensor>::const_iterator end() const { return samples.end(); }
+
+  // Whole batch access. Sample |i| starts at data() + i * sample_size().
+  float* data() { return block.data(); }
+  const float* data() const { return block.data(); }
+  size_t sample_size() const { return sample_size_; }
+
+  // The samples [begin, begin + count) as one view, with the sample index as
+  // its last dimension.
+  TensorView View(size_t begin, size_t count) const;
+
+  // A Batch sharing the block of this one, without copy. It must not outlive
+  // the block: packing or reallocating this Batch invalidates it.
+  Batch Alias();
+
+  // Whether the memory is owned by someone else. See Wrap() and Alias().
+  bool IsAlias() const { return block.IsView(); }
+
+  void Fill(float value);
+
+  // Reduced precision storage. Packing to Precision::Float32 does nothing.
+  void Pack(Precision precision);
+  void Unpack();
+  bool IsPacked() const { return precision_ != Precision::Float32; }
+
+  // Release the values, when they can be computed again. Like a packed Batch,
+  // the samples can't be accessed until Unpack() is called, which gives them
+  // an uninitialized block back.
+  void Discard();
+  bool IsDiscarded() const { return discarded_; }
+
+ private:
+  // Point the samples to their slice of the block, or to nullptr while packed.
+  void Bind();
+
+  Storage block;
+  std::vector<Tensor> samples;
+  size_t sample_size_ = 0;
+
+  // The packed values, two half-width values per float.
+  Storage packed;
+  Precision precision_ = Precision::Float32;
+
+  bool discarded_ = false;
+};
+
+#endif /* end of include guard: BATCH_H */
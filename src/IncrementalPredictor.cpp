@@ -0,0 +1,108 @@
+#include "IncrementalPredictor.hpp"
+#include "node/Bias.hpp"
+#include "node/Linear.hpp"
+
+namespace {
+
+// Full predictions happen at least this often.
+constexpr size_t max_updates = 256;
+
+// Whether the change of the output of |node| is linear in the change of its
+// input.
+bool IsAffine(Node* node) {
+  if (auto linear = dynamic_cast<Linear*>(node))
+    return linear->epilogue.activation == Epilogue::Activation::None;
+  return dynamic_cast<Bias*>(node) != nullptr;
+}
+
+}  // namespace
+
+IncrementalPredictor::IncrementalPredictor(Node* input, Node* output)
+    : input(input), output(output) {}
+
+void IncrementalPredictor::FindIncrementalNodes() {
+  incremental_nodes.clear();
+  if (!dynamic_cast<Linear*>(input->next) || !IsAffine(input->next))
+    return;
+  for (Node* node = input->next;; node = node->next) {
+    // Its output must still hold the previous prediction: it can't be shared
+    // with the other outputs. A fused or in place node writes the output of the
+    // node before it.
+    if (!node->AliasesInput() && node->output.IsAlias())
+      break;
+    incremental_nodes.push_back(node);
+    if (node == output || !IsAffine(node->next))
+      break;
+  }
+  // Nor overwritten by the next node.
+  while (!incremental_nodes.empty() && incremental_nodes.back() != output &&
+         incremental_nodes.back()->next->AliasesInput()) {
+    incremental_nodes.pop_back();
+  }
+}
+
+void IncrementalPredictor::UpdateIncrementalNodes() {
+  for (Node* node : incremental_nodes) {
+    // Its output is the one of the node before it, already updated.
+    if (node->AliasesInput())
+      continue;
+
+    if (auto linear = dynamic_cast<Linear*>(node)) {
+      linear->ForwardDelta(0, indices, deltas, output_deltas);
+      // Every output value changes.
+      indices.resize(output_deltas.size());
+      for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+      deltas.swap(output_deltas);
+      continue;
+    }
+
+    // A Bias adds a constant: the change goes through.
+    Tensor& O = node->output[0];
+    for (size_t i = 0; i < indices.size(); ++i)
+      O[indices[i]] += deltas[i];
+  }
+}
+
+const Tensor& IncrementalPredictor::Predict(const TensorView& input_value) {
+  if (!plan.IsCompiled(input, output)) {
+    plan = Plan(input, output);
+    valid = false;
+  }
+
+  Tensor& current = input->output[0];
+  FindIncrementalNodes();
+  if (!incremental_nodes.empty() && valid && updates < max_updates &&
+      previous_input.sizes == input_value.sizes) {
+    Tensor value = input_value;
+    indices.clear();
+    deltas.clear();
+    for (size_t i = 0; i < value.values.size(); ++i) {
+      if (value[i] != previous_input[i]) {
+        indices.push_back(i);
+        deltas.push_back(value[i] - previous_input[i]);
+      }
+    }
+
+    if (2 * indices.size() < value.values.size()) {
+      current = value;
+      previous_input = std::move(value);
+      UpdateIncrementalNodes();
+      // The fused nodes don't run on their own.
+      Node* last = incremental_nodes.back();
+      while (last->fused_into)
+        last = last->fused_into;
+      plan.ForwardAfter(last, 1);
+      ++updates;
+      ++incremental_predictions_;
+      return output->output[0];
+    }
+  }
+
+  current = input_value;
+  previous_input = input_value;
+  plan.Forward(1, false);
+  valid = !incremental_nodes.empty();
+  updates = 0;
+  return output->output[0];
+}
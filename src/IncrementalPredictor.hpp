@@ -0,0 +1,59 @@
+#ifndef INCREMENTAL_PREDICTOR_H
+#define INCREMENTAL_PREDICTOR_H
+
+#include <vector>
+#include "Plan.hpp"
+
+// Predictions for an input changing a few values at a time, like a slider
+// moving one coordinate of a latent vector.
+//
+// When the first node is a Linear, its output is updated with the columns of
+// its params matching the changed values, instead of being computed again.
+// The change then goes through the Bias and Linear nodes right after it, as
+// long as none applies an activation: their outputs are updated by the change
+// of their input. The nodes after them run as usual: a nonlinearity changes
+// everything after it anyway. Otherwise, or when most of the input changed,
+// it falls back to a full forward pass.
+//
+// The predictor assumes nothing else runs the nodes or changes their params
+// between two predictions. Call Reset() after training.
+class IncrementalPredictor {
+ public:
+  IncrementalPredictor(Node* input, Node* output);
+
+  // The output of the network for |input|. It is only valid until the network
+  // is run again.
+  const Tensor& Predict(const TensorView& input);
+
+  // Forget the previous input. The next prediction is a full one.
+  void Reset() { valid = false; }
+
+  // Number of predictions made by updating the Linear output.
+  size_t incremental_predictions() const { return incremental_predictions_; }
+
+ private:
+  // Find the nodes whose output can be updated: the first Linear, and the Bias
+  // and Linear nodes following it. Empty if there are none.
+  void FindIncrementalNodes();
+  // Update the outputs of the nodes found, from the change of the input in
+  // |indices| and |deltas|.
+  void UpdateIncrementalNodes();
+
+  Node* input;
+  Node* output;
+  Plan plan;
+  std::vector<Node*> incremental_nodes;
+
+  Tensor previous_input;
+  bool valid = false;
+  // Incremental updates since the last full prediction. The rounding errors
+  // add up, so a full prediction is made from time to time.
+  size_t updates = 0;
+  size_t incremental_predictions_ = 0;
+
+  std::vector<size_t> indices;
+  std::vector<float> deltas;
+  std::vector<float> output_deltas;
+};
+
+#endif /* end of include guard: INCREMENTAL_PREDICTOR_H */
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include "IncrementalPredictor.hpp"
+#include "TensorExpression.hpp"
+#include "node/Bias.hpp"
+#include "node/Input.hpp"
+#include "node/LeakyRelu.hpp"
+#include "node/Linear.hpp"
+#include "node/Sigmoid.hpp"
+#include "node/Tanh.hpp"
+#include "pass/Fusion.hpp"
+#include "pass/InPlace.hpp"
+#include "test/TwinModels.hpp"
+
+namespace {
+
+// Input -> Linear -> LeakyRelu -> Linear -> Sigmoid
+struct Network {
+  Network()
+      : input({10}),
+        linear_1(&input, {4, 4, 2}),
+        leaky_relu(&linear_1),
+        linear_2(&leaky_relu, {5}),
+        sigmoid(&linear_2) {}
+
+  Input input;
+  Linear linear_1;
+  LeakyRelu leaky_relu;
+  Linear linear_2;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+// Input -> Linear -> Bias -> Linear -> Bias -> Tanh
+struct Affine {
+  Affine()
+      : input({10}),
+        linear_1(&input, {6}),
+        bias_1(&linear_1),
+        linear_2(&bias_1, {5}),
+        bias_2(&linear_2),
+        tanh(&bias_2) {}
+
+  Input input;
+  Linear linear_1;
+  Bias bias_1;
+  Linear linear_2;
+  Bias bias_2;
+  Tanh tanh;
+  Node* output = &tanh;
+};
+
+// Input -> Linear -> Sigmoid
+//       -> Linear -> Tanh
+// Like the discriminator of a GAN, the input is linked to one branch at a time.
+struct Branches {
+  Branches()
+      : input({10}),
+        linear_a(&input, {5}),
+        sigmoid_a(&linear_a),
+        linear_b(&input, {4}),
+        tanh_b(&linear_b) {}
+
+  Input input;
+  Linear linear_a;
+  Sigmoid sigmoid_a;
+  Linear linear_b;
+  Tanh tanh_b;
+  Node* output = &tanh_b;
+};
+
+}  // namespace
+
+TEST(IncrementalPredictor, SameResults) {
+  TwinModels<Network> twins;
+  Network& reference = twins.reference;
+  Network& network = twins.network;
+
+  IncrementalPredictor predictor(&network.input, &network.sigmoid);
+  Tensor latent = Tensor::Random({10});
+  auto expect_same = [&] {
+    const Tensor expected = twins.reference_model.Predict(latent);
+    EXPECT_LT((expected - predictor.Predict(latent)).Error(), 1e-10);
+  };
+
+  // The first prediction is a full one.
+  expect_same();
+  EXPECT_EQ(predictor.incremental_predictions(), 0u);
+
+  // Moving one coordinate at a time.
+  for (size_t i = 0; i < 20; ++i) {
+    latent[i % 10] += 0.1f;
+    expect_same();
+  }
+  EXPECT_EQ(predictor.incremental_predictions(), 20u);
+
+  // A new input.
+  latent = Tensor::Random({10});
+  expect_same();
+  EXPECT_EQ(predictor.incremental_predictions(), 20u);
+
+  // New params.
+  reference.linear_1.params *= 0.5f;
+  network.linear_1.params *= 0.5f;
+  predictor.Reset();
+  expect_same();
+  latent[3] = 0.f;
+  expect_same();
+  EXPECT_EQ(predictor.incremental_predictions(), 21u);
+}
+
+// The change goes through the Bias and Linear nodes, whether they run on their
+// own, in place, or fused.
+TEST(IncrementalPredictor, AffineNodes) {
+  for (int variant = 0; variant < 3; ++variant) {
+    SCOPED_TRACE(variant);
+    TwinModels<Affine> twins;
+    Affine& network = twins.network;
+    if (variant == 1) {
+      EXPECT_EQ(pass::RunInPlace(&network.input, &network.tanh), 3u);
+    }
+    if (variant == 2) {
+      EXPECT_EQ(pass::Fuse(&network.input, &network.tanh), 3u);
+    }
+
+    IncrementalPredictor predictor(&network.input, &network.tanh);
+    Tensor latent = Tensor::Random({10});
+    for (size_t i = 0; i < 20; ++i) {
+      latent[i % 10] += 0.1f;
+      const Tensor expected = twins.reference_model.Predict(latent);
+      EXPECT_LT((expected - predictor.Predict(latent)).Error(), 1e-10);
+    }
+    EXPECT_EQ(predictor.incremental_predictions(), 19u);
+  }
+}
+
+// Each branch has its own predictor. Switching branches changes the graph, so
+// the first prediction after it is a full one.
+TEST(IncrementalPredictor, SharedInput) {
+  TwinModels<Branches> twins;
+  Branches& reference = twins.reference;
+  Branches& network = twins.network;
+  Model reference_a(&reference.input, &reference.sigmoid_a);
+  Model& reference_b = twins.reference_model;
+
+  IncrementalPredictor predictor_a(&network.input, &network.sigmoid_a);
+  IncrementalPredictor predictor_b(&network.input, &network.tanh_b);
+  Tensor latent_a = Tensor::Random({10});
+  Tensor latent_b = Tensor::Random({10});
+  for (size_t i = 0; i < 4; ++i) {
+    Node::Link(&reference.input, &reference.linear_a);
+    Node::Link(&network.input, &network.linear_a);
+    for (size_t j = 0; j < 5; ++j) {
+      latent_a[j] += 0.1f;
+      const Tensor expected = reference_a.Predict(latent_a);
+      EXPECT_LT((expected - predictor_a.Predict(latent_a)).Error(), 1e-10);
+    }
+
+    Node::Link(&reference.input, &reference.linear_b);
+    Node::Link(&network.input, &network.linear_b);
+    for (size_t j = 0; j < 5; ++j) {
+      latent_b[j] -= 0.1f;
+      const Tensor expected = reference_b.Predict(latent_b);
+      EXPECT_LT((expected - predictor_b.Predict(latent_b)).Error(), 1e-10);
+    }
+  }
+  EXPECT_EQ(predictor_a.incremental_predictions(), 16u);
+  EXPECT_EQ(predictor_b.incremental_predictions(), 16u);
+}
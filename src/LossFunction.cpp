@@ -1,12 +1,13 @@
 #include "LossFunction.hpp"
 #include <cmath>
 #include <iostream>
+#include "TensorExpression.hpp"
 #include "util/stable_softmax.hpp"
 
 namespace LossFunction {
 
-void SquaredDifference(const Tensor& target,
-                       const Tensor& current,
+void SquaredDifference(const TensorView& target,
+                       const TensorView& current,
                        float* error,
                        Tensor* derivative) {
   *derivative = current - target;
@@ -14,14 +15,14 @@ void SquaredDifference(const Tensor& target,
 }
 
 // Sum(target, log(current));
-void CrossEntropy(const Tensor& target,
-                  const Tensor& current,
+void CrossEntropy(const TensorView& target,
+                  const TensorView& current,
                   float* error,
                   Tensor* derivative) {
   *error = 0.f;
   *derivative = Tensor(target.sizes);
   derivative->Fill(0.f);
-  for (size_t i = 0; i < target.values.size(); ++i) {
+  for (size_t i = 0; i < target.Elements(); ++i) {
     //if (current[i] * (1.f - current[i]) > 0.000000000001f) {
       ///[>error += -target[i] * log(current[i]);
       if (target[i] > 0.5f) {
@@ -40,14 +41,14 @@ void CrossEntropy(const Tensor& target,
   //SquaredDifference(target, current, error, derivative);
 }
 
-void SoftmaxCrossEntropy(const Tensor& target,
-                         const Tensor& current,
+void SoftmaxCrossEntropy(const TensorView& target,
+                         const TensorView& current,
                          float* error,
                          Tensor* derivative) {
-  const size_t size = target.values.size();
+  const size_t size = target.Elements();
   *derivative = Tensor(size);
-  std::vector<float> softmax(size);
-  StableSoftmax(current.values, softmax);
+  Tensor softmax(size);
+  StableSoftmax(current.data, softmax.values.data(), size);
 
   *error = 0.f;
   for (size_t i = 0; i < size; ++i) {
@@ -62,8 +63,8 @@ void SoftmaxCrossEntropy(const Tensor& target,
     (*derivative)[i] = softmax[i] - target[i];
 }
 
-void WasserStein(const Tensor& target,
-                 const Tensor& current,
+void WasserStein(const TensorView& target,
+                 const TensorView& current,
                  float* error,
                  Tensor* derivative) {
   *error = target[0] * current[0];
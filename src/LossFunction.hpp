@@ -2,13 +2,15 @@
 #define LOSSFUNCTION_H
 
 #include "Tensor.hpp"
+#include "TensorView.hpp"
 
 namespace LossFunction {
 
-using F = void(const Tensor&,  // target
-               const Tensor&,  // current
-               float*,         // error
-               Tensor*);       // derivative
+// |target| and |current| must be contiguous.
+using F = void(const TensorView&,  // target
+               const TensorView&,  // current
+               float*,             // error
+               Tensor*);           // derivative
 
 // 
 // ⌠        2
@@ -1,33 +1,67 @@
 #include "Model.hpp"
+#include "Pool.hpp"
+#include "TensorExpression.hpp"
 #include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <cmath>
 
-Model::Model(Node* input, Node* output, const std::vector<Example>& examples)
-    : input(input), output(output), examples(examples) {}
+Model::Model(Node* input, Node* output, std::vector<Example> examples)
+    : input(input), output(output), examples(std::move(examples)) {}
 
 Model::Model(Node* input, Node* output) : Model(input, output, {}) {}
 
 void Model::Train(float lambda, size_t iterations) {
-  std::vector<Tensor> error_sensitivity(Node::T,
-                                        Tensor(output->output[0].sizes));
+  Profiler::Scope scope(profiler_.get(), nullptr, Profiler::Phase::Train,
+                        iterations);
+  if (prediction_cache_)
+    prediction_cache_->Clear();
+  Plan& plan = GetPlan();
+  plan.Apply(&Node::AllocateTrainingBuffers);
+  shared_outputs = pass::SharedOutputs();
+  const size_t capacity = input->capacity();
+  Batch error_sensitivity(capacity, output->output[0].sizes);
   float sum_error = 0.f;
   for (size_t i = 0; i < iterations;) {
-    size_t elements = std::min(Node::T, iterations - i);
-
-    // Feed the neural network.
-    for (size_t t = 0; t < elements; ++t) {
-      input->output[t] = examples[(iteration + t) % examples.size()].input;
+    size_t elements = std::min(capacity, iterations - i);
+
+    const size_t allocations = Pool::Allocations();
+    Tracer::SetActive(tracer_.get());
+    sum_error += TrainStep(plan, error_sensitivity, elements, lambda);
+    Tracer::SetActive(nullptr);
+    last_allocations = Pool::Allocations() - allocations;
+    if (tracer_ && --trace_steps_ == 0) {
+      tracer_->WriteToFile(trace_filename_);
+      tracer_.reset();
     }
 
-    // Make a prediction.
-    Range(input->next, output).Apply([&](Node* node) {
-      node->Forward(elements);
-    });
+    i += elements;
+    iteration += elements;
+  }
+
+  last_error = sum_error / iterations;
+}
+
+float Model::TrainStep(Plan& plan,
+                       Batch& error_sensitivity,
+                       size_t elements,
+                       float lambda) {
+  Tracer::Span span("Model::Train step", "model");
+
+  // Feed the neural network.
+  for (size_t t = 0; t < elements; ++t) {
+    input->output[t] = examples[(iteration + t) % examples.size()].input;
+  }
 
-    // Compute the error.
+  // Make a prediction. Once consumed, the reduced precision outputs are
+  // packed until the backward pass.
+  plan.Forward(elements, true);
+
+  // Compute the error.
+  float sum_error = 0.f;
+  {
+    Tracer::Span span("loss_function", "model");
     for (size_t t = 0; t < elements; ++t) {
       const Tensor& target = examples[(iteration + t) % examples.size()].output;
       const Tensor& current = output->output[t];
@@ -36,41 +70,84 @@ void Model::Train(float lambda, size_t iterations) {
       sum_error += current_error;
       output->output_sensitivity[t] = &(error_sensitivity[t]);
     }
+  }
 
-    // Compute the sensitivity.
-    ReverseRange(output, input->next).Apply([&](Node* node) {
-      node->Backward(elements);
-    });
+  // Compute the sensitivity.
+  plan.Backward(elements);
 
-    // Update the network.
-    Range(input->next, output).Apply([&](Node* node) {
-      node->Update(elements, lambda);
-    });
+  // Update the network.
+  plan.Update(elements, lambda);
 
+  {
+    Tracer::Span span("post_update_function", "model");
     post_update_function(this);
-
-    i += elements;
-    iteration += elements;
   }
 
-  last_error = sum_error / iterations;
+  return sum_error;
 }
 
-Tensor Model::Predict(const Tensor& input_value) {
+TensorView Model::Predict(const TensorView& input_value) {
+  Profiler::Scope scope(profiler_.get(), nullptr, Profiler::Phase::Predict, 1);
+  if (prediction_cache_) {
+    if (const Tensor* prediction = prediction_cache_->Find(input_value))
+      return *prediction;
+  }
   // Feed the neural network.
   input->output[0] = input_value;
 
   // Make a prediction.
-  Range(input->next, output).Apply([](Node* node) { node->Forward(1); });
+  GetPlan().Forward(1, false);
 
+  if (prediction_cache_)
+    return prediction_cache_->Insert(input_value, output->output[0]);
   return output->output[0];
 }
 
+Plan& Model::GetPlan() {
+  if (!compiled_plan.IsCompiled(input, output))
+    compiled_plan = Plan(input, output);
+  compiled_plan.profiler = profiler_.get();
+  return compiled_plan;
+}
+
+void Model::SetBatchCapacity(size_t capacity) {
+  Range(input, output).Apply([capacity](Node* node) {
+    node->SetCapacity(capacity);
+  });
+}
+
+void Model::InferenceOnly(size_t capacity) {
+  Range(input, output).Apply(&Node::InferenceOnly);
+  SetBatchCapacity(capacity);
+  shared_outputs = pass::ShareOutputs(input, output);
+}
+
+void Model::SetCheckpoints(const std::vector<Node*>& checkpoints) {
+  Range(input->next, output).Apply([&checkpoints](Node* node) {
+    node->recompute = std::find(checkpoints.begin(), checkpoints.end(),
+                                node) == checkpoints.end();
+  });
+  output->recompute = false;
+  Node::InvalidatePlans();
+}
+
+void Model::CheckpointEvery(size_t every) {
+  std::vector<Node*> checkpoints;
+  size_t index = 0;
+  Range(input->next, output).Apply([&](Node* node) {
+    // The fused nodes don't have their own output.
+    if (node->fused_into)
+      return;
+    if (every == 0 || ++index % every == 0)
+      checkpoints.push_back(node);
+  });
+  SetCheckpoints(checkpoints);
+}
+
 float Model::Error() {
   float error = 0;
   for (auto& example : examples) {
-    Tensor output = Predict(example.input);
-    error += (output - example.output).Error();
+    error += (Predict(example.input) - example.output).Error();
   }
   error /= float(examples.size());
   return error;
@@ -91,6 +168,10 @@ float Model::LastError() {
   return last_error;
 }
 
+size_t Model::LastAllocations() {
+  return last_allocations;
+}
+
 std::vector<float> Model::SerializeParams() {
   std::vector<float> value;
   Range(input, output).Apply([&value](Node* node) {
@@ -104,6 +185,8 @@ void Model::DeserializeParams(const std::vector<float>& value) {
   Range(input, output).Apply([&value, &index](Node* node) {
     node->DeserializeParams(value, index);
   });
+  if (prediction_cache_)
+    prediction_cache_->Clear();
 }
 
 static std::ifstream::pos_type FileSize(const std::string& filename) {
@@ -138,3 +221,23 @@ void Model::PrintGradient() {
     std::cerr << "Layer = " << std::sqrt(sum_X / sum_1) << std::endl;
   });
 }
+
+void Model::EnableProfiling(bool enabled) {
+  profiler_.reset(enabled ? new Profiler() : nullptr);
+  compiled_plan.profiler = profiler_.get();
+}
+
+std::string Model::ProfileTable() const {
+  return profiler_ ? profiler_->Table() : std::string();
+}
+
+void Model::TraceToFile(const std::string& filename, size_t steps) {
+  tracer_.reset(steps ? new Tracer() : nullptr);
+  trace_filename_ = filename;
+  trace_steps_ = steps;
+}
+
+void Model::EnablePredictionCache(size_t capacity, float precision) {
+  prediction_cache_.reset(capacity ? new PredictionCache(capacity, precision)
+                                   : nullptr);
+}
@@ -1,8 +1,14 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <memory>
 #include "node/Node.hpp"
 #include "LossFunction.hpp"
+#include "Plan.hpp"
+#include "PredictionCache.hpp"
+#include "Profiler.hpp"
+#include "Tracer.hpp"
+#include "pass/Memory.hpp"
 #include "PostUpdateFunction.hpp"
 
 struct Example {
@@ -12,15 +18,57 @@ struct Example {
 
 class Model {
  public:
-  Model(Node* input, Node* output, const std::vector<Example>& examples);
+  Model(Node* input, Node* output, std::vector<Example> examples);
   Model(Node* input, Node* output);
 
   void Train(float lambda, size_t iteration);
-  Tensor Predict(const Tensor& input);
+
+  // The prediction is a view on the output of the network. It is only valid
+  // until the network is run again. With a prediction cache, it is a view on
+  // the cached prediction instead, valid until the next call to Predict().
+  TensorView Predict(const TensorView& input);
+
+  // Keep the last |capacity| predictions in a PredictionCache, for inputs
+  // rounded to a multiple of |precision|. Predict() returns them without
+  // running the network. Train() and loading params clear it. A zero
+  // |capacity| disables it.
+  void EnablePredictionCache(size_t capacity, float precision = 1e-4f);
+  // Null while disabled.
+  const PredictionCache* prediction_cache() const {
+    return prediction_cache_.get();
+  }
+
+  // Number of samples processed together by Train(). It defaults to the
+  // capacity given to the Input.
+  void SetBatchCapacity(size_t capacity);
+
+  // Release every buffer only used for training, and keep room for |capacity|
+  // samples. The outputs of the nodes share two buffers owned by the Model,
+  // see pass::ShareOutputs(). Use it before loading the weights of a network
+  // only used for predictions. The next call to Train() allocates the buffers
+  // again, with the same capacity.
+  void InferenceOnly(size_t capacity = 1);
+
+  // Gradient checkpointing. Training keeps the outputs of |checkpoints| until
+  // the backward pass. The other outputs of ]input, output[ are discarded once
+  // consumed, and computed again from the closest checkpoint before them when
+  // the backward pass needs them. Memory is traded for about one more forward
+  // pass. Nodes drawing random numbers, like Dropout, always keep their
+  // output.
+  void SetCheckpoints(const std::vector<Node*>& checkpoints);
+  // Keep the output of one node out of |every|. Around the square root of the
+  // depth of the network uses the least memory. Zero keeps every output.
+  void CheckpointEvery(size_t every);
+
   float Error();
   float ErrorInteger();
   float LastError();
 
+  // Number of tensor buffers obtained from the system during the last training
+  // step, the last batch of Train(). Once warm, a training step only recycles
+  // buffers from the Pool.
+  size_t LastAllocations();
+
   // Save/Load model weights.
   std::vector<float> SerializeParams();
   void DeserializeParams(const std::vector<float>& value);
@@ -29,6 +77,20 @@ class Model {
 
   void PrintGradient();
 
+  // Measure Train(), Predict(), and every call to the nodes. Disabled by
+  // default. Enabling it again starts from an empty profile.
+  void EnableProfiling(bool enabled = true);
+  // Null while disabled.
+  const Profiler* profiler() const { return profiler_.get(); }
+  // The profile as a table, one line per node and phase.
+  std::string ProfileTable() const;
+
+  // Trace the next |steps| training steps of Train(), one per batch, and
+  // write them to |filename| once done. The spans cover every node call, the
+  // loss function, the post update function, and the work of each thread in
+  // the Linear and convolution nodes. See Tracer.hpp.
+  void TraceToFile(const std::string& filename, size_t steps = 1);
+
   Node* input;
   Node* output;
   std::vector<Example> examples;
@@ -39,8 +101,30 @@ class Model {
   PostUpdateFunction::F post_update_function = PostUpdateFunction::None();
 
  private:
-  std::vector<Node*> nodes;  // ]input, output]
+  // Forward, backward and update of one batch of |elements| examples. Returns
+  // the sum of their errors.
+  float TrainStep(Plan& plan,
+                  Batch& error_sensitivity,
+                  size_t elements,
+                  float lambda);
+
+  // The plan of [input, output], compiled again when outdated.
+  Plan& GetPlan();
+  Plan compiled_plan;
+
+  std::unique_ptr<Profiler> profiler_;
+  std::unique_ptr<PredictionCache> prediction_cache_;
+
+  // While tracing, see TraceToFile().
+  std::unique_ptr<Tracer> tracer_;
+  std::string trace_filename_;
+  size_t trace_steps_ = 0;
+
+  // The memory of the outputs, while InferenceOnly().
+  pass::SharedOutputs shared_outputs;
+
   float last_error = 0.f;
+  size_t last_allocations = 0;
 };
 
 #endif /* end of include guard: MODEL_H */
@@ -1,9 +1,18 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
 #include "gtest/gtest.h"
 
+#include "node/Dropout.hpp"
 #include "node/Input.hpp"
 #include "node/Linear.hpp"
 #include "node/Sigmoid.hpp"
+#include "node/Tanh.hpp"
 #include "Model.hpp"
+#include "TensorExpression.hpp"
+#include "test/TwinModels.hpp"
 
 TEST(Model, Serialize) {
   auto input = Input({5,5});
@@ -20,3 +29,289 @@ TEST(Model, Serialize) {
   model.DeserializeParams(serialized_params);
   EXPECT_TRUE((old_linear_params - linear.params).Error() < 1e-5);
 }
+
+TEST(Model, InferenceOnly) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 10; ++i)
+    examples.push_back({Tensor::Random({5}), Tensor::Random({3})});
+
+  auto input = Input({5});
+  auto linear = Linear(&input, {3});
+  auto output = Sigmoid(&linear);
+
+  // Nothing is allocated for training before the first training step.
+  EXPECT_TRUE(linear.params_sensitivity.empty());
+  EXPECT_TRUE(linear.input_sensitivity.empty());
+
+  Model model(&input, &output, examples);
+  model.Train(0.01f, 100);
+  EXPECT_EQ(linear.params_sensitivity.size(), 1u);
+  const Tensor expected = model.Predict(examples[0].input);
+  const auto serialized_params = model.SerializeParams();
+
+  model.InferenceOnly();
+  EXPECT_TRUE(linear.params_sensitivity.empty());
+  EXPECT_TRUE(linear.input_sensitivity.empty());
+  EXPECT_EQ(linear.output.size(), 1u);
+  EXPECT_EQ(output.input.size(), 1u);
+
+  // The serialized format doesn't change.
+  linear.params.Fill(0.f);
+  model.DeserializeParams(serialized_params);
+  EXPECT_EQ(model.SerializeParams().size(), serialized_params.size());
+  EXPECT_EQ(Tensor(model.Predict(examples[0].input)), expected);
+
+  // Training allocates everything back, for the current capacity.
+  model.Train(0.01f, 100);
+  EXPECT_EQ(linear.output.size(), 1u);
+  EXPECT_EQ(linear.params_sensitivity.size(), 1u);
+  EXPECT_EQ(linear.input_sensitivity.size(), 1u);
+}
+
+TEST(Model, BatchCapacity) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 10; ++i)
+    examples.push_back({Tensor::Random({5}), Tensor::Random({3})});
+
+  // Every node gets the capacity of the input.
+  auto input = Input({5}, 4);
+  auto linear = Linear(&input, {3});
+  auto dropout = Dropout(&linear, 0.9f);
+  auto output = Sigmoid(&dropout);
+  EXPECT_EQ(input.capacity(), 4u);
+  EXPECT_EQ(output.capacity(), 4u);
+  EXPECT_EQ(output.output.size(), 4u);
+
+  Model model(&input, &output, examples);
+  model.Train(0.01f, 10);
+  EXPECT_EQ(linear.params_sensitivity.size(), 1u);
+  EXPECT_EQ(output.input_sensitivity.size(), 4u);
+
+  model.SetBatchCapacity(16);
+  EXPECT_EQ(linear.capacity(), 16u);
+  EXPECT_EQ(linear.output.size(), 16u);
+  // The gradient has a single slot, whatever the capacity.
+  EXPECT_EQ(linear.params_sensitivity.size(), 1u);
+  EXPECT_EQ(dropout.input.size(), 16u);
+  EXPECT_EQ(dropout.output_sensitivity.size(), 16u);
+  EXPECT_EQ(&dropout.input[15]->values, &linear.output[15].values);
+  EXPECT_EQ(linear.output_sensitivity[15], &dropout.input_sensitivity[15]);
+  model.Train(0.01f, 40);
+  for (Tensor& slot : linear.params_sensitivity)
+    EXPECT_EQ(slot.Error(), 0.f);
+
+  EXPECT_THROW(model.SetBatchCapacity(0), std::invalid_argument);
+}
+
+TEST(Model, Profiling) {
+  Input input({4}, 8);
+  Linear linear(&input, {3});
+  Sigmoid sigmoid(&linear);
+  std::vector<Example> examples;
+  for (int i = 0; i < 8; ++i)
+    examples.push_back({Tensor::Random({4}), Tensor::Random({3})});
+  Model model(&input, &sigmoid, examples);
+
+  // Disabled by default.
+  model.Train(0.01f, 16);
+  EXPECT_EQ(model.profiler(), nullptr);
+  EXPECT_EQ(model.ProfileTable(), "");
+
+  model.EnableProfiling();
+  model.Train(0.01f, 16);
+  model.Predict(examples[0].input);
+
+  // The forward, backward and update of the two nodes, then Model::Train and
+  // Model::Predict.
+  const auto& entries = model.profiler()->entries();
+  ASSERT_EQ(entries.size(), 8u);
+  EXPECT_EQ(entries[6].node, nullptr);
+  EXPECT_EQ(entries[6].phase, Profiler::Phase::Train);
+  EXPECT_EQ(entries[6].calls, 1u);
+  EXPECT_EQ(entries[7].phase, Profiler::Phase::Predict);
+
+  for (const auto& entry : entries) {
+    if (entry.node != &linear)
+      continue;
+    if (entry.phase == Profiler::Phase::Forward) {
+      // Two batches of 8 samples, and a prediction.
+      EXPECT_EQ(entry.calls, 3u);
+      EXPECT_EQ(entry.flops, 17u * 2 * 4 * 3);
+    } else {
+      EXPECT_EQ(entry.calls, 2u);
+    }
+    EXPECT_GT(entry.bytes, 0u);
+  }
+  EXPECT_NE(model.ProfileTable().find("Linear"), std::string::npos);
+
+  model.EnableProfiling(false);
+  EXPECT_EQ(model.profiler(), nullptr);
+}
+
+TEST(Model, Trace) {
+  Input input({4}, 8);
+  Linear linear(&input, {3});
+  Sigmoid sigmoid(&linear);
+  std::vector<Example> examples;
+  for (int i = 0; i < 8; ++i)
+    examples.push_back({Tensor::Random({4}), Tensor::Random({3})});
+  Model model(&input, &sigmoid, examples);
+
+  // Two steps out of three are traced.
+  const std::string filename = "model_trace_test.json";
+  model.TraceToFile(filename, 2);
+  model.Train(0.01f, 24);
+  EXPECT_EQ(Tracer::Active(), nullptr);
+
+  std::ifstream file(filename);
+  ASSERT_TRUE(file.good());
+  const std::string trace((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  std::remove(filename.c_str());
+
+  auto count = [&trace](const std::string& word) {
+    size_t count = 0;
+    for (size_t i = trace.find(word); i != std::string::npos;
+         i = trace.find(word, i + 1)) {
+      ++count;
+    }
+    return count;
+  };
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+  EXPECT_EQ(count("\"Model::Train step\""), 2u);
+  EXPECT_EQ(count("\"loss_function\""), 2u);
+  EXPECT_EQ(count("\"post_update_function\""), 2u);
+  EXPECT_EQ(count("\"name\":\"Linear\""), 6u);
+  // One block of outputs per Forward(), and one block of outputs and one of
+  // inputs per Backward().
+  EXPECT_EQ(count("\"Linear::Forward block\""), 2u);
+  EXPECT_EQ(count("\"Linear::Backward weights\""), 2u);
+  EXPECT_EQ(count("\"Linear::Backward inputs\""), 2u);
+  EXPECT_EQ(count("\"tid\":"), count("\"ph\":\"X\""));
+}
+
+// Each system thread has its own lane, even when both are the first thread of
+// their parallel region.
+TEST(Model, TraceThreads) {
+  Tracer tracer;
+  Tracer::SetActive(&tracer);
+  { Tracer::Span span("main", "test"); }
+  std::thread([] { Tracer::Span span("other", "test"); }).join();
+  Tracer::SetActive(nullptr);
+  EXPECT_EQ(tracer.size(), 2u);
+
+  const std::string trace = tracer.ToJSON();
+  auto lane = [&trace](const std::string& name) {
+    const size_t begin = trace.find("\"tid\":", trace.find(name));
+    return trace.substr(begin, trace.find('}', begin) - begin);
+  };
+  EXPECT_NE(lane("\"main\""), lane("\"other\""));
+}
+
+namespace {
+
+// Input -> (Linear -> Tanh) x 3 -> Linear -> Sigmoid
+struct Deep {
+  Deep()
+      : input({6}, 8),
+        linear_1(&input, {8}),
+        tanh_1(&linear_1),
+        linear_2(&tanh_1, {8}),
+        tanh_2(&linear_2),
+        linear_3(&tanh_2, {8}),
+        tanh_3(&linear_3),
+        linear_4(&tanh_3, {3}),
+        sigmoid(&linear_4) {}
+
+  Input input;
+  Linear linear_1;
+  Tanh tanh_1;
+  Linear linear_2;
+  Tanh tanh_2;
+  Linear linear_3;
+  Tanh tanh_3;
+  Linear linear_4;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+// Input -> Linear -> Tanh -> Dropout -> Linear -> Tanh -> Linear -> Sigmoid
+struct WithDropout {
+  WithDropout()
+      : input({6}, 8),
+        linear_1(&input, {8}),
+        tanh_1(&linear_1),
+        dropout(&tanh_1, 0.7f),
+        linear_2(&dropout, {8}),
+        tanh_2(&linear_2),
+        linear_3(&tanh_2, {3}),
+        sigmoid(&linear_3) {}
+
+  Input input;
+  Linear linear_1;
+  Tanh tanh_1;
+  Dropout dropout;
+  Linear linear_2;
+  Tanh tanh_2;
+  Linear linear_3;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+std::vector<Example> DeepExamples() {
+  std::vector<Example> examples;
+  for (int i = 0; i < 16; ++i)
+    examples.push_back({Tensor::Random({6}), Tensor::Random({3})});
+  return examples;
+}
+
+}  // namespace
+
+TEST(Model, Checkpoints) {
+  TwinModels<Deep> twins(DeepExamples());
+  Deep& deep = twins.network;
+  Model& model = twins.model;
+
+  model.CheckpointEvery(3);
+  EXPECT_TRUE(deep.linear_1.recompute);
+  EXPECT_TRUE(deep.tanh_1.recompute);
+  EXPECT_FALSE(deep.linear_2.recompute);
+  EXPECT_FALSE(deep.tanh_3.recompute);
+  EXPECT_FALSE(deep.sigmoid.recompute);
+
+  // The recomputed outputs are the same, and so are the gradients.
+  twins.Train(0.01f, 16, 4);
+  EXPECT_TRUE(twins.SameParams());
+  EXPECT_EQ(model.LastError(), twins.reference_model.LastError());
+
+  // Between two training steps, only the checkpoints keep their output.
+  EXPECT_TRUE(deep.linear_1.output.IsDiscarded());
+  EXPECT_TRUE(deep.tanh_2.output.IsDiscarded());
+  EXPECT_FALSE(deep.linear_2.output.IsDiscarded());
+  EXPECT_FALSE(deep.sigmoid.output.IsDiscarded());
+
+  // Predictions compute them again.
+  EXPECT_TRUE(twins.SamePrediction(model.examples[0].input));
+
+  model.CheckpointEvery(0);
+  EXPECT_FALSE(deep.tanh_1.recompute);
+}
+
+// A Dropout inside a recomputed segment keeps its output: running it again
+// would draw other values.
+TEST(Model, CheckpointsWithDropout) {
+  TwinModels<WithDropout> twins(DeepExamples());
+  WithDropout& network = twins.network;
+  twins.model.SetCheckpoints({&network.tanh_2});
+  EXPECT_TRUE(network.dropout.recompute);
+
+  twins.Train(0.01f, 16, 4);
+  EXPECT_TRUE(twins.SameParams());
+  EXPECT_EQ(twins.model.LastError(), twins.reference_model.LastError());
+
+  EXPECT_TRUE(network.tanh_1.output.IsDiscarded());
+  EXPECT_FALSE(network.dropout.output.IsDiscarded());
+  EXPECT_TRUE(network.linear_2.output.IsDiscarded());
+  EXPECT_FALSE(network.tanh_2.output.IsDiscarded());
+  EXPECT_TRUE(twins.SamePredictions());
+}
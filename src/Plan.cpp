@@ -0,0 +1,129 @@
+#include "Plan.hpp"
+#include "Tracer.hpp"
+
+namespace {
+
+// Whether the output of |node| is shared with another node. It can't be
+// packed then.
+bool IsShared(const Node* node) {
+  return node->AliasesInput() || (node->next && node->next->AliasesInput());
+}
+
+bool IsDiscarded(const Node* node) {
+  return node->recompute && node->CanRecompute();
+}
+
+}  // namespace
+
+Plan::Plan(Node* input, Node* output) : generation_(Node::LinkGeneration()) {
+  for (Node* node = input;; node = node->next) {
+    nodes_.push_back(node);
+    if (node == output)
+      break;
+  }
+
+  for (size_t i = 1; i < nodes_.size(); ++i) {
+    Node* node = nodes_[i];
+    if (node->fused_into)
+      continue;
+    Node* producer = node->previous;
+    if (producer->fused_into)
+      producer = producer->fused_into;
+    const bool pack_node = !IsShared(node) && node != output;
+    const bool pack_producer = !IsShared(producer) && producer != input;
+    steps_.push_back({
+        node,
+        producer,
+        pack_node,
+        pack_producer,
+        pack_node && IsDiscarded(node),
+        pack_producer && IsDiscarded(producer),
+    });
+  }
+}
+
+bool Plan::IsCompiled(Node* input, Node* output) const {
+  return !nodes_.empty() && nodes_.front() == input &&
+         nodes_.back() == output && generation_ == Node::LinkGeneration();
+}
+
+void Plan::Forward(size_t batch_size, bool training) {
+  for (const Step& step : steps_) {
+    step.node->output.Unpack();
+    {
+      Profiler::Scope scope(profiler, step.node, Profiler::Phase::Forward,
+                            batch_size);
+      Tracer::Span span(step.node, "forward");
+      step.node->Forward(batch_size);
+    }
+    if (training && step.discard_producer)
+      step.producer->output.Discard();
+    else if (training && step.pack_producer)
+      step.producer->output.Pack(step.producer->precision);
+  }
+}
+
+void Plan::ForwardAfter(const Node* node, size_t batch_size) {
+  size_t i = 0;
+  while (i < steps_.size() && steps_[i].node != node)
+    ++i;
+  for (++i; i < steps_.size(); ++i) {
+    const Step& step = steps_[i];
+    step.node->output.Unpack();
+    Profiler::Scope scope(profiler, step.node, Profiler::Phase::Forward,
+                          batch_size);
+    Tracer::Span span(step.node, "forward");
+    step.node->Forward(batch_size);
+  }
+}
+
+void Plan::Backward(size_t batch_size) {
+  for (size_t i = steps_.size(); i-- > 0;) {
+    const Step* step = &steps_[i];
+    if (step->discard_producer && step->producer->output.IsDiscarded())
+      Recompute(i, batch_size);
+    step->node->output.Unpack();
+    step->producer->output.Unpack();
+    {
+      Profiler::Scope scope(profiler, step->node, Profiler::Phase::Backward,
+                            batch_size);
+      Tracer::Span span(step->node, "backward");
+      step->node->Backward(batch_size);
+    }
+    if (step->discard_node)
+      step->node->output.Discard();
+    else if (step->pack_node)
+      step->node->output.Pack(step->node->precision);
+  }
+}
+
+void Plan::Recompute(size_t end, size_t batch_size) {
+  size_t begin = end;
+  while (begin > 0 && steps_[begin - 1].node->output.IsDiscarded())
+    --begin;
+
+  for (size_t i = begin; i < end; ++i) {
+    const Step& step = steps_[i];
+    step.producer->output.Unpack();
+    step.node->output.Unpack();
+    Profiler::Scope scope(profiler, step.node, Profiler::Phase::Recompute,
+                          batch_size);
+    Tracer::Span span(step.node, "recompute");
+    step.node->Forward(batch_size);
+  }
+}
+
+void Plan::Update(size_t batch_size, float lambda) {
+  const size_t size = nodes_.size();
+  for (size_t i = 1; i < size; ++i) {
+    Profiler::Scope scope(profiler, nodes_[i], Profiler::Phase::Update,
+                          batch_size);
+    Tracer::Span span(nodes_[i], "update");
+    nodes_[i]->Update(batch_size, lambda);
+  }
+}
+
+void Plan::Apply(void (Node::*f)()) {
+  for (Node* node : nodes_)
+    (node->*f)();
+}
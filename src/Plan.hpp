@@ -0,0 +1,71 @@
+#ifndef PLAN_H
+#define PLAN_H
+
+#include <vector>
+#include "Profiler.hpp"
+#include "node/Node.hpp"
+
+// The nodes from |input| to |output|, flattened once in the order they run.
+//
+// Walking a Plan is a loop over an array, instead of following the linked
+// list and calling through a std::function for every node and every phase.
+// The Plan is outdated as soon as the graph is linked differently, see
+// Node::LinkGeneration(). Model compiles a new one when needed.
+class Plan {
+ public:
+  Plan() = default;
+  Plan(Node* input, Node* output);
+
+  // Whether this is the plan of [input, output], and is still up to date.
+  bool IsCompiled(Node* input, Node* output) const;
+
+  // Run the nodes after the input, in order. The nodes fused into another one
+  // are skipped. While |training|, an output is packed to its precision once
+  // consumed, until Backward() needs it, or discarded if it is to be
+  // recomputed.
+  void Forward(size_t batch_size, bool training);
+
+  // Run the nodes after the input, in reverse order. A node needs its own
+  // output and its input, which are unpacked first. The discarded outputs are
+  // computed again when needed, see Node::recompute.
+  void Backward(size_t batch_size);
+
+  // Run the nodes after |node|, for inference. Used when the output of |node|
+  // was updated by other means.
+  void ForwardAfter(const Node* node, size_t batch_size);
+
+  void Update(size_t batch_size, float lambda);
+
+  // Apply |f| to every node, the input included.
+  void Apply(void (Node::*f)());
+
+  // [input, output]
+  const std::vector<Node*>& nodes() const { return nodes_; }
+
+  // Measures every call to a node, when not null.
+  Profiler* profiler = nullptr;
+
+ private:
+  struct Step {
+    Node* node;
+    // The node computing the input of |node|.
+    Node* producer;
+    // Whether the outputs can be packed. Not the input, nor an output
+    // shared with other nodes.
+    bool pack_node;
+    bool pack_producer;
+    // Whether the outputs are discarded instead, see Node::recompute.
+    bool discard_node;
+    bool discard_producer;
+  };
+
+  // Run again the steps before |end| whose output was discarded, from the
+  // last output kept.
+  void Recompute(size_t end, size_t batch_size);
+
+  std::vector<Node*> nodes_;
+  std::vector<Step> steps_;
+  size_t generation_ = 0;
+};
+
+#endif /* end of include guard: PLAN_H */
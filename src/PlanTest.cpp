@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+
+#include "Model.hpp"
+#include "Plan.hpp"
+#include "node/Input.hpp"
+#include "node/Linear.hpp"
+#include "node/Relu.hpp"
+#include "node/Sigmoid.hpp"
+
+TEST(Plan, Nodes) {
+  Input input({3});
+  Linear linear(&input, {2});
+  Sigmoid sigmoid(&linear);
+
+  Plan plan(&input, &sigmoid);
+  EXPECT_EQ(plan.nodes(), std::vector<Node*>({&input, &linear, &sigmoid}));
+  EXPECT_TRUE(plan.IsCompiled(&input, &sigmoid));
+  EXPECT_FALSE(plan.IsCompiled(&input, &linear));
+
+  // Linking the same nodes again keeps the plan.
+  Node::Link(&linear, &sigmoid);
+  EXPECT_TRUE(plan.IsCompiled(&input, &sigmoid));
+
+  // Changing the graph doesn't.
+  Relu relu(&linear);
+  Node::Link(&relu, &sigmoid);
+  EXPECT_FALSE(plan.IsCompiled(&input, &sigmoid));
+}
+
+TEST(Plan, ModelFollowsTheGraph) {
+  Input input({3});
+  Linear linear(&input, {2});
+  Sigmoid sigmoid(&linear);
+  Model model(&input, &sigmoid);
+
+  Tensor x({3});
+  x.values = {1.f, -2.f, 3.f};
+  const Tensor before = model.Predict(x);
+
+  // Insert a Relu between the Linear and the Sigmoid.
+  Relu relu(&linear);
+  Node::Link(&relu, &sigmoid);
+  const Tensor after = model.Predict(x);
+
+  linear.Forward(1);
+  relu.Forward(1);
+  sigmoid.Forward(1);
+  EXPECT_EQ(after, Tensor(sigmoid.output[0]));
+  for (size_t i = 0; i < 2; ++i)
+    EXPECT_GE(after[i], 0.5f);
+  EXPECT_EQ(before.sizes, after.sizes);
+}
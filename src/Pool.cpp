@@ -0,0 +1,169 @@
+#include "Pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace Pool {
+
+namespace {
+
+// Bytes kept by each thread for its own use. Recycling them takes no lock.
+constexpr size_t thread_cache_bytes = 1 << 20;
+
+std::atomic<size_t> allocations(0);
+
+struct FreeList {
+  std::unordered_map<size_t, std::vector<void*>> blocks;  // By size.
+  size_t bytes = 0;
+
+  void* Pop(size_t size) {
+    auto it = blocks.find(size);
+    if (it == blocks.end() || it->second.empty())
+      return nullptr;
+    void* data = it->second.back();
+    it->second.pop_back();
+    bytes -= size;
+    return data;
+  }
+
+  void Push(void* data, size_t size) {
+    blocks[size].push_back(data);
+    bytes += size;
+  }
+};
+
+// The blocks shared by every thread.
+struct SharedFreeList : public FreeList {
+  std::mutex mutex;
+  size_t max_bytes = default_max_cached_bytes;
+};
+
+// Never destroyed, so that global Tensors can still release their memory at
+// exit.
+SharedFreeList& shared_free_list() {
+  static SharedFreeList* free_list = new SharedFreeList;
+  return *free_list;
+}
+
+// The pointer returned by malloc is stored right before the aligned block.
+void* AlignedAllocate(size_t bytes) {
+  void* raw = std::malloc(bytes + alignment + sizeof(void*));
+  if (!raw)
+    throw std::bad_alloc();
+  const uintptr_t address = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+  void* data = reinterpret_cast<void*>((address + alignment - 1) &
+                                       ~uintptr_t(alignment - 1));
+  static_cast<void**>(data)[-1] = raw;
+  return data;
+}
+
+void AlignedFree(void* data) {
+  std::free(static_cast<void**>(data)[-1]);
+}
+
+// Release blocks of |list| until it keeps at most |max_bytes|.
+void Trim(FreeList& list, size_t max_bytes) {
+  for (auto& it : list.blocks) {
+    while (list.bytes > max_bytes && !it.second.empty()) {
+      AlignedFree(it.second.back());
+      it.second.pop_back();
+      list.bytes -= it.first;
+    }
+  }
+}
+
+void FreeShared(void* data, size_t bytes) {
+  SharedFreeList& list = shared_free_list();
+  {
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (list.bytes + bytes <= list.max_bytes) {
+      list.Push(data, bytes);
+      return;
+    }
+  }
+  AlignedFree(data);
+}
+
+// Set once the cache of the thread is destroyed. The Tensors freed after it
+// go to the shared list.
+thread_local bool thread_exiting = false;
+
+// Hands its blocks to the shared list when the thread exits.
+struct ThreadCache {
+  ~ThreadCache() {
+    thread_exiting = true;
+    for (auto& it : list.blocks) {
+      for (void* data : it.second)
+        FreeShared(data, it.first);
+    }
+  }
+  FreeList list;
+};
+
+// The blocks of the calling thread, or null when it is exiting.
+FreeList* thread_free_list() {
+  if (thread_exiting)
+    return nullptr;
+  thread_local ThreadCache cache;
+  return &cache.list;
+}
+
+}  // namespace
+
+void* Allocate(size_t bytes) {
+  if (FreeList* list = thread_free_list()) {
+    if (void* data = list->Pop(bytes))
+      return data;
+  }
+  {
+    SharedFreeList& list = shared_free_list();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (void* data = list.Pop(bytes))
+      return data;
+  }
+  ++allocations;
+  return AlignedAllocate(bytes);
+}
+
+void Free(void* data, size_t bytes) {
+  FreeList* list = thread_free_list();
+  if (list && list->bytes + bytes <= thread_cache_bytes) {
+    list->Push(data, bytes);
+    return;
+  }
+  FreeShared(data, bytes);
+}
+
+size_t Allocations() {
+  return allocations;
+}
+
+void SetMaxCachedBytes(size_t bytes) {
+  SharedFreeList& list = shared_free_list();
+  std::lock_guard<std::mutex> lock(list.mutex);
+  list.max_bytes = bytes;
+  Trim(list, bytes);
+}
+
+size_t CachedBytes() {
+  SharedFreeList& list = shared_free_list();
+  std::lock_guard<std::mutex> lock(list.mutex);
+  return list.bytes;
+}
+
+void Clear() {
+  if (FreeList* list = thread_free_list()) {
+    Trim(*list, 0);
+    list->blocks.clear();
+  }
+  SharedFreeList& list = shared_free_list();
+  std::lock_guard<std::mutex> lock(list.mutex);
+  Trim(list, 0);
+  list.blocks.clear();
+}
+
+}  // namespace Pool
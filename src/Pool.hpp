@@ -0,0 +1,41 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+
+using std::size_t;
+
+// Aligned memory blocks, recycled by size.
+//
+// Freed blocks are kept and handed back to the next request of the same size,
+// so that a training loop reallocating the same tensors over and over stops
+// hitting malloc once it reaches its steady state.
+//
+// Each thread keeps up to 1 MiB of freed blocks for itself, recycled without
+// locking. The others go to a list shared by every thread, up to
+// SetMaxCachedBytes(). Blocks freed beyond it go back to the system.
+namespace Pool {
+
+// Every block is aligned on a cache line. This is enough for any SIMD load.
+constexpr size_t alignment = 64;
+
+void* Allocate(size_t bytes);
+void Free(void* data, size_t bytes);
+
+// Number of blocks requested to the system so far. Blocks recycled from the
+// pool are not counted.
+size_t Allocations();
+
+// Limit the bytes kept by the shared list. The excess is released now.
+constexpr size_t default_max_cached_bytes = size_t(256) << 20;
+void SetMaxCachedBytes(size_t bytes);
+// Bytes kept by the shared list.
+size_t CachedBytes();
+
+// Give the blocks kept for recycling back to the system: those of the shared
+// list, and those of the calling thread.
+void Clear();
+
+}  // namespace Pool
+
+#endif /* end of include guard: POOL_H */
@@ -0,0 +1,17 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+// How the values of a Batch are stored while they are only kept around for a
+// later use, for instance the activations between the forward and the backward
+// pass. Computations always happen in float.
+//
+// The half-width formats halve the memory and bandwidth used:
+// - BFloat16 keeps the range of a float, with 8 bits of mantissa.
+// - Float16 has 11 bits of mantissa, but saturates above 65504.
+enum class Precision {
+  Float32,
+  BFloat16,
+  Float16,
+};
+
+#endif /* end of include guard: PRECISION_H */
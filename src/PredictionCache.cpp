@@ -0,0 +1,85 @@
+#include "PredictionCache.hpp"
+#include <cmath>
+#include <stdexcept>
+
+PredictionCache::PredictionCache(size_t capacity, float precision)
+    : capacity_(capacity), precision(precision) {
+  if (capacity == 0)
+    throw std::invalid_argument(
+        "PredictionCache: the capacity must be positive");
+  if (!(precision > 0.f))
+    throw std::invalid_argument(
+        "PredictionCache: the precision must be positive");
+}
+
+size_t PredictionCache::KeyHash::operator()(const Key& key) const {
+  // FNV-1a, over the 64 bits of every value.
+  uint64_t hash = 14695981039346656037ull;
+  for (int64_t value : key) {
+    hash ^= static_cast<uint64_t>(value);
+    hash *= 1099511628211ull;
+  }
+  return static_cast<size_t>(hash);
+}
+
+bool PredictionCache::Quantize(const TensorView& input) {
+  // llround() is undefined for NaN, infinite values, and values out of the
+  // range of int64_t.
+  constexpr float max_rounded = 4.6e18f;  // About 2^62.
+  key.resize(input.sizes.size() + input.Elements());
+  size_t i = 0;
+  for (size_t size : input.sizes)
+    key[i++] = size;
+  bool valid = true;
+  input.ForEach([&](float value) {
+    const float scaled = value / precision;
+    if (std::abs(scaled) <= max_rounded)
+      key[i++] = std::llround(scaled);
+    else
+      valid = false;
+  });
+  return valid;
+}
+
+const Tensor* PredictionCache::Find(const TensorView& input) {
+  if (!Quantize(input)) {
+    ++misses_;
+    return nullptr;
+  }
+  auto it = index.find(key);
+  if (it == index.end()) {
+    ++misses_;
+    return nullptr;
+  }
+
+  ++hits_;
+  entries.splice(entries.begin(), entries, it->second);
+  return &entries.front().prediction;
+}
+
+const Tensor& PredictionCache::Insert(const TensorView& input,
+                                      const TensorView& prediction) {
+  if (!Quantize(input)) {
+    uncached = prediction;
+    return uncached;
+  }
+  auto it = index.find(key);
+  if (it != index.end()) {
+    entries.splice(entries.begin(), entries, it->second);
+    entries.front().prediction = prediction;
+    return entries.front().prediction;
+  }
+
+  if (entries.size() == capacity_) {
+    index.erase(entries.back().key);
+    entries.pop_back();
+  }
+  entries.push_front({key, prediction});
+  index.emplace(key, entries.begin());
+  return entries.front().prediction;
+}
+
+void PredictionCache::Clear() {
+  entries.clear();
+  index.clear();
+}
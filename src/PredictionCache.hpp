@@ -0,0 +1,66 @@
+#ifndef PREDICTION_CACHE_H
+#define PREDICTION_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "Tensor.hpp"
+#include "TensorView.hpp"
+
+// The last predictions of a network, by input. Two inputs are the same once
+// their values are rounded to a multiple of |precision|.
+//
+// Interactive clients query the same inputs over and over, like a slider
+// dragged back and forth. A hit costs a hash of the input, and doesn't run
+// the network. The least recently used prediction is evicted first. See
+// Model::EnablePredictionCache().
+class PredictionCache {
+ public:
+  PredictionCache(size_t capacity, float precision);
+
+  // The prediction stored for |input|, or null. It stays valid until it is
+  // evicted, or the cache cleared. Inputs with a NaN, an infinite value, or a
+  // value too large to be rounded are never stored.
+  const Tensor* Find(const TensorView& input);
+
+  // Store the |prediction| for |input|, and return its copy. For an input that
+  // can't be stored, the copy is only valid until the next call.
+  const Tensor& Insert(const TensorView& input, const TensorView& prediction);
+
+  // To be called whenever the params of the network change.
+  void Clear();
+
+  size_t size() const { return entries.size(); }
+  size_t capacity() const { return capacity_; }
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  using Key = std::vector<int64_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct Entry {
+    Key key;
+    Tensor prediction;
+  };
+
+  // Fills |key|. Returns false when a value can't be rounded.
+  bool Quantize(const TensorView& input);
+
+  size_t capacity_;
+  float precision;
+
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+  Key key;
+  // The last prediction of an input that can't be stored.
+  Tensor uncached;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+#endif /* end of include guard: PREDICTION_CACHE_H */
@@ -0,0 +1,104 @@
+#include <limits>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+#include "Model.hpp"
+#include "PredictionCache.hpp"
+#include "TensorView.hpp"
+#include "node/Input.hpp"
+#include "node/Linear.hpp"
+#include "node/Sigmoid.hpp"
+
+TEST(PredictionCache, LeastRecentlyUsed) {
+  PredictionCache cache(2, 0.01f);
+  Tensor a({2}), b({2}), c({2});
+  a.values = {0.f, 1.f};
+  b.values = {1.f, 0.f};
+  c.values = {1.f, 1.f};
+
+  EXPECT_EQ(cache.Find(a), nullptr);
+  cache.Insert(a, a);
+  cache.Insert(b, b);
+  ASSERT_NE(cache.Find(a), nullptr);
+  EXPECT_EQ(*cache.Find(a), a);
+
+  // |b| is the least recently used.
+  cache.Insert(c, c);
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.Find(b), nullptr);
+  EXPECT_NE(cache.Find(c), nullptr);
+  EXPECT_EQ(cache.hits(), 3u);
+  EXPECT_EQ(cache.misses(), 2u);
+
+  // Close inputs share their prediction.
+  Tensor close = a;
+  close[0] += 0.001f;
+  EXPECT_EQ(cache.Find(close), cache.Find(a));
+  close[0] += 0.1f;
+  EXPECT_EQ(cache.Find(close), nullptr);
+
+  // The shape is part of the key.
+  Tensor reshaped({1, 2});
+  reshaped.values = {0.f, 1.f};
+  EXPECT_EQ(cache.Find(reshaped), nullptr);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Find(a), nullptr);
+
+  EXPECT_THROW(PredictionCache(0, 0.1f), std::invalid_argument);
+  EXPECT_THROW(PredictionCache(1, 0.f), std::invalid_argument);
+}
+
+TEST(PredictionCache, StridedInput) {
+  PredictionCache cache(2, 0.01f);
+  Tensor a({2, 2});
+  a.values = {0.f, 1.f, 2.f, 3.f};
+  Tensor column({1, 2});
+  column.values = {1.f, 3.f};
+
+  cache.Insert(column, column);
+  const TensorView view = TensorView(a).Slice(0, 1, 1);
+  ASSERT_FALSE(view.IsContiguous());
+  ASSERT_NE(cache.Find(view), nullptr);
+  EXPECT_EQ(*cache.Find(view), column);
+}
+
+TEST(PredictionCache, NotFinite) {
+  PredictionCache cache(2, 0.01f);
+  for (float value : {std::numeric_limits<float>::quiet_NaN(),
+                      std::numeric_limits<float>::infinity(),
+                      -std::numeric_limits<float>::infinity(), 1e30f}) {
+    Tensor input({2});
+    input.values = {0.f, value};
+    const Tensor& prediction = cache.Insert(input, input);
+    EXPECT_EQ(prediction.values[0], 0.f);
+    EXPECT_EQ(cache.Find(input), nullptr);
+  }
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.misses(), 4u);
+}
+
+TEST(PredictionCache, Model) {
+  Input input({3});
+  Linear linear(&input, {2});
+  Sigmoid sigmoid(&linear);
+  std::vector<Example> examples = {{Tensor::Random({3}), Tensor::Random({2})}};
+  Model model(&input, &sigmoid, examples);
+  model.EnablePredictionCache(16);
+
+  const Tensor expected = model.Predict(examples[0].input);
+  EXPECT_EQ(model.prediction_cache()->misses(), 1u);
+
+  // A hit doesn't run the network.
+  sigmoid.output[0].Fill(0.f);
+  EXPECT_EQ(Tensor(model.Predict(examples[0].input)), expected);
+  EXPECT_EQ(model.prediction_cache()->hits(), 1u);
+
+  // Training changes the params.
+  model.Train(0.1f, 4);
+  EXPECT_EQ(model.prediction_cache()->size(), 0u);
+  EXPECT_NE(Tensor(model.Predict(examples[0].input)), expected);
+
+  model.EnablePredictionCache(0);
+  EXPECT_EQ(model.prediction_cache(), nullptr);
+}
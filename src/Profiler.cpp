@@ -0,0 +1,142 @@
+#include "Profiler.hpp"
+#include <cstdio>
+#include "node/Node.hpp"
+
+namespace {
+
+std::string NameOf(const Node* node) {
+  return node ? node->Name() : "Model";
+}
+
+const char* NameOf(Profiler::Phase phase) {
+  switch (phase) {
+    case Profiler::Phase::Train:
+      return "Train";
+    case Profiler::Phase::Predict:
+      return "Predict";
+    case Profiler::Phase::Forward:
+      return "Forward";
+    case Profiler::Phase::Recompute:
+      return "Recompute";
+    case Profiler::Phase::Backward:
+      return "Backward";
+    case Profiler::Phase::Update:
+      return "Update";
+  }
+  return "";
+}
+
+// Floats read or written by one call, estimated from the buffers the phase
+// touches.
+size_t Floats(const Node* node, Profiler::Phase phase, size_t batch_size) {
+  const size_t params = node->params.values.size();
+  const size_t input = node->previous ? node->previous->output.sample_size() : 0;
+  const size_t output = node->output.sample_size();
+  switch (phase) {
+    case Profiler::Phase::Forward:
+    case Profiler::Phase::Recompute:
+      return batch_size * (input + output) + params;
+    case Profiler::Phase::Backward:
+      // The input, the output and their sensitivities, the params and their
+      // gradient.
+      return 2 * batch_size * (input + output) + 2 * params;
+    case Profiler::Phase::Update:
+      // The params, the gradient, and the two ADAM moments.
+      return 4 * params;
+    default:
+      return 0;
+  }
+}
+
+size_t Flops(const Node* node, Profiler::Phase phase, size_t batch_size) {
+  const size_t params = node->params.values.size();
+  switch (phase) {
+    case Profiler::Phase::Forward:
+    case Profiler::Phase::Recompute:
+      return batch_size * node->Flops();
+    case Profiler::Phase::Backward:
+      // The sensitivity of the input, and the gradient of the params.
+      return batch_size * node->Flops() * (params ? 2 : 1);
+    case Profiler::Phase::Update:
+      // ADAM uses about ten operations per param.
+      return node->locked ? 0 : 10 * params;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+Profiler::Scope::Scope(Profiler* profiler,
+                       const Node* node,
+                       Phase phase,
+                       size_t batch_size)
+    : profiler(profiler), node(node), phase(phase), batch_size(batch_size) {
+  if (profiler)
+    start = std::chrono::steady_clock::now();
+}
+
+Profiler::Scope::~Scope() {
+  if (!profiler)
+    return;
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  profiler->Record(node, phase, elapsed.count(), batch_size);
+}
+
+void Profiler::Record(const Node* node,
+                      Phase phase,
+                      double seconds,
+                      size_t batch_size) {
+  auto key = std::make_pair(node, phase);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    it = index_.emplace(key, entries_.size()).first;
+    entries_.push_back({node, phase});
+  }
+
+  Entry& entry = entries_[it->second];
+  entry.calls++;
+  entry.seconds += seconds;
+  if (node) {
+    entry.flops += Flops(node, phase, batch_size);
+    entry.bytes += Floats(node, phase, batch_size) * sizeof(float);
+  }
+}
+
+void Profiler::Clear() {
+  entries_.clear();
+  index_.clear();
+}
+
+std::string Profiler::Table() const {
+  // The node calls share the time of the model calls containing them.
+  double total = 0.0;
+  for (const Entry& entry : entries_) {
+    if (entry.node)
+      total += entry.seconds;
+  }
+
+  std::string table;
+  char line[256];
+  std::snprintf(line, sizeof(line), "%-4s %-20s %-9s %8s %10s %6s %10s %10s\n",
+                "#", "node", "phase", "calls", "ms", "%", "MFLOP", "MB");
+  table += line;
+  for (const Entry& entry : entries_) {
+    size_t position = 0;
+    for (const Node* node = entry.node; node && node->previous;
+         node = node->previous) {
+      ++position;
+    }
+    char share[16] = "";
+    if (entry.node && total > 0.0)
+      std::snprintf(share, sizeof(share), "%.1f", 100.0 * entry.seconds / total);
+    std::snprintf(line, sizeof(line),
+                  "%-4zu %-20s %-9s %8zu %10.3f %6s %10.3f %10.3f\n", position,
+                  NameOf(entry.node).c_str(), NameOf(entry.phase), entry.calls,
+                  entry.seconds * 1e3, share, entry.flops * 1e-6,
+                  entry.bytes * 1e-6);
+    table += line;
+  }
+  return table;
+}
@@ -0,0 +1,68 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+class Node;
+
+// Where the time of a Model goes. Records, for every node and every phase, the
+// wall time, the number of calls, and an estimate of the floating point
+// operations and of the bytes moved. See Model::EnableProfiling().
+//
+// A disabled profiler is a null pointer: the Plan only checks it around each
+// call.
+class Profiler {
+ public:
+  enum class Phase {
+    // A whole call to Model::Train() or Model::Predict(). |node| is null.
+    Train,
+    Predict,
+    // A call to one node.
+    Forward,
+    // Forward() again, for the backward pass. See Model::SetCheckpoints().
+    Recompute,
+    Backward,
+    Update,
+  };
+
+  struct Entry {
+    const Node* node;
+    Phase phase;
+    size_t calls = 0;
+    double seconds = 0.0;
+    size_t flops = 0;
+    size_t bytes = 0;
+  };
+
+  // Measure the lifetime of the Scope. Does nothing without a profiler.
+  class Scope {
+   public:
+    Scope(Profiler* profiler, const Node* node, Phase phase, size_t batch_size);
+    ~Scope();
+
+   private:
+    Profiler* profiler;
+    const Node* node;
+    Phase phase;
+    size_t batch_size;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // In the order their first call ended.
+  const std::vector<Entry>& entries() const { return entries_; }
+  void Clear();
+
+  // One line per node and phase, with the share of the total time.
+  std::string Table() const;
+
+ private:
+  void Record(const Node* node, Phase phase, double seconds, size_t batch_size);
+
+  std::vector<Entry> entries_;
+  std::map<std::pair<const Node*, Phase>, size_t> index_;
+};
+
+#endif /* end of include guard: PROFILER_H */
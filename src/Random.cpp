@@ -0,0 +1,114 @@
+#include "Random.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t philox_m0 = 0xD2511F53;
+constexpr uint32_t philox_m1 = 0xCD9E8D57;
+constexpr uint32_t philox_w0 = 0x9E3779B9;
+constexpr uint32_t philox_w1 = 0xBB67AE85;
+constexpr int philox_rounds = 10;
+
+// The keys of the global generator and of the objects owning one. The initial
+// global key is arbitrary.
+std::atomic<uint64_t> global_key(1);
+std::atomic<uint64_t> next_key(global_key + 1);
+std::atomic<uint64_t> next_global_stream(0);
+
+// Number of random words generated in a row, before converting them.
+constexpr size_t chunk = 64;
+
+// 24 random bits, mapped to [0, 1).
+float ToUniform(uint32_t x) {
+  return (x >> 8) * (1.f / 16777216.f);
+}
+
+}  // namespace
+
+Random::Random(uint64_t key, uint64_t stream, uint32_t substream) {
+  key_[0] = uint32_t(key);
+  key_[1] = uint32_t(key >> 32);
+  counter_[0] = 0;
+  counter_[1] = substream;
+  counter_[2] = uint32_t(stream);
+  counter_[3] = uint32_t(stream >> 32);
+}
+
+// static
+Random Random::Global() {
+  return Random(global_key, next_global_stream++);
+}
+
+// static
+uint64_t Random::NewKey() {
+  return next_key++;
+}
+
+// static
+void Random::SeedGlobal(uint64_t seed) {
+  global_key = seed;
+  next_key = seed + 1;
+  next_global_stream = 0;
+}
+
+void Random::Next(uint32_t* output) {
+  uint32_t c[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+  uint32_t k[2] = {key_[0], key_[1]};
+  for (int round = 0; round < philox_rounds; ++round) {
+    const uint64_t p0 = uint64_t(philox_m0) * c[0];
+    const uint64_t p1 = uint64_t(philox_m1) * c[2];
+    const uint32_t next[4] = {
+        uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1),
+        uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0),
+    };
+    c[0] = next[0];
+    c[1] = next[1];
+    c[2] = next[2];
+    c[3] = next[3];
+    k[0] += philox_w0;
+    k[1] += philox_w1;
+  }
+  output[0] = c[0];
+  output[1] = c[1];
+  output[2] = c[2];
+  output[3] = c[3];
+
+  // Only the first word counts the position. The substream lives in the
+  // second one.
+  ++counter_[0];
+}
+
+void Random::Uniform(float* data, size_t size) {
+  uint32_t bits[chunk];
+  for (size_t begin = 0; begin < size; begin += chunk) {
+    const size_t count = std::min(chunk, size - begin);
+    for (size_t i = 0; i < count; i += 4)
+      Next(bits + i);
+    for (size_t i = 0; i < count; ++i)
+      data[begin + i] = ToUniform(bits[i]);
+  }
+}
+
+void Random::Normal(float* data, size_t size, float mean, float sigma) {
+  // Each pair of uniform values gives a pair of normal values.
+  constexpr float two_pi = 6.28318530718f;
+  uint32_t bits[chunk];
+  float output[chunk];
+  for (size_t begin = 0; begin < size; begin += chunk) {
+    const size_t count = std::min(chunk, size - begin);
+    for (size_t i = 0; i < count; i += 4)
+      Next(bits + i);
+    for (size_t i = 0; i < (count + 1) / 2; ++i) {
+      // In (0, 1], since the logarithm must stay finite.
+      const float u = 1.f - ToUniform(bits[2 * i]);
+      const float v = ToUniform(bits[2 * i + 1]);
+      const float radius = sigma * std::sqrt(-2.f * std::log(u));
+      output[2 * i] = mean + radius * std::cos(two_pi * v);
+      output[2 * i + 1] = mean + radius * std::sin(two_pi * v);
+    }
+    for (size_t i = 0; i < count; ++i)
+      data[begin + i] = output[i];
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+using std::size_t;
+
+// A counter-based random generator (Philox4x32-10).
+//
+// The values are a pure function of (key, stream, substream, position). Any
+// number of independent generators can be created for free, for instance one
+// per sample of a batch, so that random nodes run in parallel and produce the
+// same values whatever the number of threads.
+class Random {
+ public:
+  Random(uint64_t key, uint64_t stream, uint32_t substream = 0);
+
+  // A fresh stream of the global generator. The sequence of streams is
+  // deterministic, in the order of the calls.
+  static Random Global();
+
+  // A key never returned before, for objects owning their own generator.
+  static uint64_t NewKey();
+
+  // Restart the global generator from |seed|: the streams of Global() and the
+  // keys of NewKey() start over. A test relying on random values calls it
+  // first, so that it draws the same values whatever ran before it.
+  static void SeedGlobal(uint64_t seed);
+
+  // Uniform values in [0, 1).
+  void Uniform(float* data, size_t size);
+
+  // Normally distributed values (Box-Muller).
+  void Normal(float* data, size_t size, float mean = 0.f, float sigma = 1.f);
+
+ private:
+  // Generate the next 4 random words.
+  void Next(uint32_t* output);
+
+  uint32_t key_[2];
+  uint32_t counter_[4];
+};
+
+#endif /* end of include guard: RANDOM_H */
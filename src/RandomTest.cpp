@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "Random.hpp"
+
+// Known answer of Philox4x32-10 for a null key and counter.
+TEST(Random, Philox) {
+  float values[4];
+  Random(0, 0, 0).Uniform(values, 4);
+  EXPECT_EQ(values[0], float(0x6627e8d5 >> 8) / 16777216.f);
+  EXPECT_EQ(values[1], float(0xe169c58d >> 8) / 16777216.f);
+  EXPECT_EQ(values[2], float(0xbc57ac4c >> 8) / 16777216.f);
+  EXPECT_EQ(values[3], float(0x9b00dbd8 >> 8) / 16777216.f);
+}
+
+TEST(Random, Streams) {
+  std::vector<float> a(100), b(100), c(100);
+  Random(1, 2, 3).Normal(a.data(), a.size());
+  Random(1, 2, 3).Normal(b.data(), b.size());
+  Random(1, 2, 4).Normal(c.data(), c.size());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+}
+
+TEST(Random, Distributions) {
+  const size_t size = 100001;
+  std::vector<float> values(size);
+
+  Random(1, 0).Uniform(values.data(), size);
+  float sum = 0.f;
+  for (float v : values) {
+    EXPECT_GE(v, 0.f);
+    EXPECT_LT(v, 1.f);
+    sum += v;
+  }
+  EXPECT_NEAR(sum / size, 0.5f, 0.01f);
+
+  Random(1, 1).Normal(values.data(), size, 2.f, 3.f);
+  float sum_squares = 0.f;
+  sum = 0.f;
+  for (float v : values) {
+    EXPECT_TRUE(std::isfinite(v));
+    sum += v;
+    sum_squares += v * v;
+  }
+  const float mean = sum / size;
+  EXPECT_NEAR(mean, 2.f, 0.05f);
+  EXPECT_NEAR(std::sqrt(sum_squares / size - mean * mean), 3.f, 0.05f);
+}
+
+TEST(Random, SeedGlobal) {
+  std::vector<float> a(10), b(10), c(10);
+  Random::SeedGlobal(7);
+  Random::Global().Uniform(a.data(), a.size());
+  const uint64_t key = Random::NewKey();
+  Random::Global().Uniform(b.data(), b.size());
+  EXPECT_NE(a, b);
+
+  Random::SeedGlobal(7);
+  Random::Global().Uniform(c.data(), c.size());
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(Random::NewKey(), key);
+
+  Random::SeedGlobal(8);
+  Random::Global().Uniform(c.data(), c.size());
+  EXPECT_NE(a, c);
+}
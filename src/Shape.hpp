@@ -0,0 +1,73 @@
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+using std::size_t;
+
+// The sizes of a Tensor along each of its dimensions.
+//
+// They are stored inline, so that copying a Tensor doesn't allocate for its
+// shape. A Tensor has at most |max_rank| dimensions.
+class Shape {
+ public:
+  static constexpr size_t max_rank = 4;
+
+  constexpr Shape() = default;
+  constexpr Shape(std::initializer_list<size_t> sizes) {
+    if (sizes.size() > max_rank)
+      throw std::invalid_argument("Shape: too many dimensions");
+    for (size_t s : sizes)
+      sizes_[rank_++] = s;
+  }
+  Shape(const std::vector<size_t>& sizes) {
+    if (sizes.size() > max_rank)
+      throw std::invalid_argument("Shape: too many dimensions");
+    for (size_t s : sizes)
+      sizes_[rank_++] = s;
+  }
+
+  constexpr size_t size() const { return rank_; }
+  constexpr bool empty() const { return rank_ == 0; }
+  constexpr size_t operator[](size_t i) const { return sizes_[i]; }
+  constexpr size_t& operator[](size_t i) { return sizes_[i]; }
+  constexpr const size_t* begin() const { return sizes_; }
+  constexpr const size_t* end() const { return sizes_ + rank_; }
+
+  // Append a dimension.
+  constexpr void push_back(size_t size) {
+    if (rank_ == max_rank)
+      throw std::invalid_argument("Shape: too many dimensions");
+    sizes_[rank_++] = size;
+  }
+
+  // The number of elements of a Tensor of this shape.
+  constexpr size_t Elements() const {
+    size_t elements = 1;
+    for (size_t i = 0; i < rank_; ++i)
+      elements *= sizes_[i];
+    return elements;
+  }
+
+  constexpr bool operator==(const Shape& other) const {
+    if (rank_ != other.rank_)
+      return false;
+    for (size_t i = 0; i < rank_; ++i) {
+      if (sizes_[i] != other.sizes_[i])
+        return false;
+    }
+    return true;
+  }
+  constexpr bool operator!=(const Shape& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  size_t sizes_[max_rank] = {};
+  size_t rank_ = 0;
+};
+
+#endif /* end of include guard: SHAPE_H */
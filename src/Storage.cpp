@@ -0,0 +1,126 @@
+#include "Storage.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "Arena.hpp"
+#include "Pool.hpp"
+
+Storage::Storage(size_t size) {
+  Allocate(size);
+  std::fill(begin(), end(), 0.f);
+}
+
+Storage::Storage(const std::vector<float>& values) {
+  CopyFrom(values.data(), values.size());
+}
+
+Storage::Storage(std::initializer_list<float> values) {
+  CopyFrom(values.begin(), values.size());
+}
+
+Storage::~Storage() {
+  Release();
+}
+
+// static
+Storage Storage::View(float* data, size_t size) {
+  Storage storage;
+  storage.data_ = data;
+  storage.size_ = size;
+  storage.owner_ = false;
+  return storage;
+}
+
+// static
+Storage Storage::Uninitialized(size_t size) {
+  Storage storage;
+  storage.Allocate(size);
+  return storage;
+}
+
+Storage::Storage(const Storage& other) {
+  CopyFrom(other.data_, other.size_);
+}
+
+Storage::Storage(Storage&& other)
+    : data_(other.data_),
+      size_(other.size_),
+      owner_(other.owner_),
+      arena_(other.arena_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.owner_ = true;
+  other.arena_ = false;
+}
+
+Storage& Storage::operator=(const Storage& other) {
+  if (data_ != other.data_)
+    CopyFrom(other.data_, other.size_);
+  return *this;
+}
+
+Storage& Storage::operator=(Storage&& other) {
+  if (this == &other)
+    return *this;
+
+  // A view keeps referring to its slice, the values are copied into it.
+  if (!owner_)
+    return *this = static_cast<const Storage&>(other);
+
+  Release();
+  data_ = other.data_;
+  size_ = other.size_;
+  owner_ = other.owner_;
+  arena_ = other.arena_;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.owner_ = true;
+  other.arena_ = false;
+  return *this;
+}
+
+void Storage::Reset() {
+  Release();
+}
+
+void Storage::Rebind(float* data) {
+  if (owner_)
+    throw std::invalid_argument("Storage: only a view can be rebound");
+  data_ = data;
+}
+
+bool Storage::operator==(const Storage& other) const {
+  return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+void Storage::Allocate(size_t size) {
+  Arena* arena = Arena::Current();
+  const size_t bytes = size * sizeof(float);
+  if (!size)
+    data_ = nullptr;
+  else if (arena)
+    data_ = static_cast<float*>(arena->Allocate(bytes, Pool::alignment));
+  else
+    data_ = static_cast<float*>(Pool::Allocate(bytes));
+  size_ = size;
+  owner_ = true;
+  arena_ = size && arena;
+}
+
+void Storage::Release() {
+  if (owner_ && data_ && !arena_)
+    Pool::Free(data_, size_ * sizeof(float));
+  data_ = nullptr;
+  size_ = 0;
+  owner_ = true;
+  arena_ = false;
+}
+
+void Storage::CopyFrom(const float* data, size_t size) {
+  if (!owner_ && size != size_)
+    throw std::invalid_argument("Storage: size doesn't match the view");
+  if (owner_ && size != size_) {
+    Release();
+    Allocate(size);
+  }
+  std::copy(data, data + size, data_);
+}
@@ -0,0 +1,76 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+using std::size_t;
+
+// A contiguous array of float backing a Tensor.
+//
+// A Storage either owns its memory, or is a view on a slice of a bigger block
+// owned by someone else (see Batch). Assigning to a view copies the values
+// into the slice, so that the block stays shared.
+//
+// Owned memory comes from the Pool: it is aligned on Pool::alignment, and
+// recycled when released. Within an Arena::Scope, it is carved from the Arena
+// instead, which releases it.
+class Storage {
+ public:
+  Storage() = default;
+  explicit Storage(size_t size);
+  Storage(const std::vector<float>& values);
+  Storage(std::initializer_list<float> values);
+  ~Storage();
+
+  // A non-owning Storage referring to [data, data + size).
+  static Storage View(float* data, size_t size);
+
+  // An owning Storage whose values are left uninitialized, for when they are
+  // about to be overwritten anyway.
+  static Storage Uninitialized(size_t size);
+
+  // Copies are always owning.
+  Storage(const Storage& other);
+  Storage(Storage&& other);
+  Storage& operator=(const Storage& other);
+  Storage& operator=(Storage&& other);
+
+  bool IsView() const { return !owner_; }
+
+  // Make a view refer to another slice of the same size. The values aren't
+  // copied.
+  void Rebind(float* data);
+
+  // Release the memory, or stop viewing it. The Storage is then an empty
+  // owning one, which can be assigned anything.
+  void Reset();
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  float* data() { return data_; }
+  const float* data() const { return data_; }
+  float* begin() { return data_; }
+  float* end() { return data_ + size_; }
+  const float* begin() const { return data_; }
+  const float* end() const { return data_ + size_; }
+  float& operator[](size_t i) { return data_[i]; }
+  const float& operator[](size_t i) const { return data_[i]; }
+
+  bool operator==(const Storage& other) const;
+  bool operator!=(const Storage& other) const { return !(*this == other); }
+
+ private:
+  void Allocate(size_t size);
+  void Release();
+  void CopyFrom(const float* data, size_t size);
+
+  float* data_ = nullptr;
+  size_t size_ = 0;
+  bool owner_ = true;
+  // Whether the memory belongs to an Arena.
+  bool arena_ = false;
+};
+
+#endif /* end of include guard: STORAGE_H */
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <thread>
+#include "Allocator.hpp"
+#include "Model.hpp"
+#include "Pool.hpp"
+#include "node/Input.hpp"
+
+TEST(Storage, Aligned) {
+  for (size_t size = 1; size < 100; ++size) {
+    Tensor tensor(size);
+    auto address = reinterpret_cast<uintptr_t>(tensor.values.data());
+    EXPECT_EQ(address % Pool::alignment, 0u);
+  }
+}
+
+TEST(Storage, View) {
+  Batch batch(4, {3});
+  batch[2].values = {1.f, 2.f, 3.f};
+  EXPECT_EQ(batch.data()[6], 1.f);
+  EXPECT_EQ(batch.data()[8], 3.f);
+
+  // Copying a view gives an independent tensor.
+  Tensor copy = batch[2];
+  copy[0] = 4.f;
+  EXPECT_EQ(batch[2][0], 1.f);
+
+  // A view can't change its size.
+  EXPECT_THROW(batch[2].values = {1.f}, std::invalid_argument);
+}
+
+TEST(Storage, PoolCapacity) {
+  Pool::Clear();
+  const size_t allocations = Pool::Allocations();
+  void* data = Pool::Allocate(256);
+  Pool::Free(data, 256);
+  EXPECT_EQ(Pool::Allocate(256), data);
+  EXPECT_EQ(Pool::Allocations(), allocations + 1);
+  Pool::Free(data, 256);
+  // The thread keeps it for itself.
+  EXPECT_EQ(Pool::CachedBytes(), 0u);
+
+  // Beyond what the thread keeps, the blocks are shared up to the limit.
+  const size_t megabyte = 1 << 20;
+  Pool::SetMaxCachedBytes(4 * megabyte);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 6; ++i)
+    blocks.push_back(Pool::Allocate(megabyte));
+  for (void* block : blocks)
+    Pool::Free(block, megabyte);
+  EXPECT_EQ(Pool::CachedBytes(), 4 * megabyte);
+  Pool::SetMaxCachedBytes(megabyte);
+  EXPECT_EQ(Pool::CachedBytes(), megabyte);
+  Pool::SetMaxCachedBytes(Pool::default_max_cached_bytes);
+  Pool::Clear();
+  EXPECT_EQ(Pool::CachedBytes(), 0u);
+
+  // A thread gives its blocks to the others when it exits.
+  std::thread([] { Pool::Free(Pool::Allocate(512), 512); }).join();
+  EXPECT_EQ(Pool::CachedBytes(), 512u);
+  Pool::Clear();
+}
+
+TEST(Storage, NoSteadyStateAllocation) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 10; ++i)
+    examples.push_back({Tensor::Random({5}), Tensor::Random({3})});
+
+  Input input({5});
+  Allocator a;
+  auto output = a.Sigmoid(a.Linear(&input, {3}));
+
+  Model model(&input, output, examples);
+  model.Train(0.01f, 100);
+  model.Train(0.01f, 100);
+  EXPECT_EQ(model.LastAllocations(), 0u);
+}
+
+TEST(Storage, Pack) {
+  Batch batch(3, {5});
+  for (size_t i = 0; i < batch.sample_size() * batch.size(); ++i)
+    batch.data()[i] = 1.f + 1.f / (1.f + i);
+  const Batch reference = batch;
+  const Tensor* sample = &batch[1];
+
+  for (Precision precision : {Precision::BFloat16, Precision::Float16}) {
+    batch = reference;
+    sample = &batch[1];
+    batch.Pack(precision);
+    EXPECT_TRUE(batch.IsPacked());
+    EXPECT_EQ(batch.data(), nullptr);
+
+    batch.Unpack();
+    EXPECT_FALSE(batch.IsPacked());
+    EXPECT_EQ(sample, &batch[1]);
+    EXPECT_EQ(sample->values.data(), batch.data() + batch.sample_size());
+
+    // bfloat16 keeps 8 bits of mantissa, float16 keeps 11 bits.
+    const float tolerance = precision == Precision::BFloat16 ? 1.f / 128.f
+                                                             : 1.f / 1024.f;
+    for (size_t i = 0; i < batch.sample_size() * batch.size(); ++i)
+      EXPECT_NEAR(batch.data()[i], reference.data()[i], tolerance);
+  }
+}
+
+TEST(Storage, ReducedPrecisionTraining) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 10; ++i)
+    examples.push_back({Tensor::Random({5}), Tensor::Random({3})});
+
+  Input input({5});
+  Allocator a;
+  auto hidden = a.Sigmoid(a.Linear(&input, {8}));
+  auto output = a.Linear(hidden, {3});
+  Range(input.next, hidden).Apply([](Node* node) {
+    node->precision = Precision::BFloat16;
+  });
+
+  Model model(&input, output, examples);
+  const float initial_error = model.Error();
+  for (int i = 0; i < 100; ++i)
+    model.Train(0.01f, 64);
+
+  // The activations are kept packed between two training steps.
+  EXPECT_TRUE(hidden->output.IsPacked());
+  EXPECT_LT(model.Error(), initial_error);
+}
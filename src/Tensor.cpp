@@ -1,36 +1,50 @@
 #include "Tensor.hpp"
 #include <algorithm>
-#include <random>
+#include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include "Random.hpp"
+#include "TensorView.hpp"
+#include "kernel/Kernel.hpp"
 
 Tensor::Tensor() : Tensor({}) {}
-Tensor::Tensor(size_t size) : Tensor(std::vector<size_t>{size}) {}
-Tensor::Tensor(const std::vector<size_t>& sizes)
-    : values(Multiply(sizes), 0.f), sizes(sizes) {}
+Tensor::Tensor(size_t size) : Tensor(Shape{size}) {}
+Tensor::Tensor(const Shape& sizes)
+    : values(Multiply(sizes)), sizes(sizes) {}
 
-void Tensor::Fill(float value) {
-  std::fill(values.begin(), values.end(), value);
+Tensor::Tensor(const TensorView& view) : Tensor(view.sizes) {
+  view.CopyTo(values.data());
 }
 
-Tensor Tensor::operator-(const Tensor& tensor) const {
-  Tensor output = *this;
-  for (size_t i = 0; i < values.size(); ++i) {
-    output[i] -= tensor.values.at(i);
+Tensor& Tensor::operator=(const TensorView& view) {
+  if (values.size() != view.Elements()) {
+    if (values.IsView())
+      throw std::invalid_argument("Tensor: size doesn't match the view");
+    values = Storage(view.Elements());
   }
-  return output;
+  sizes = view.sizes;
+  view.CopyTo(values.data());
+  return *this;
+}
+
+// static
+Tensor Tensor::View(const Shape& sizes, float* data) {
+  Tensor tensor;
+  tensor.sizes = sizes;
+  tensor.values = Storage::View(data, Multiply(sizes));
+  return tensor;
+}
+
+void Tensor::Fill(float value) {
+  kernel::Get().Fill(values.data(), values.size(), value);
 }
 
 void Tensor::operator*=(float lambda) {
-  for (auto& it : values) {
-    it *= lambda;
-  }
+  kernel::Get().Scale(values.data(), values.size(), lambda);
 }
 
 void Tensor::operator+=(const Tensor& other) {
-  for (size_t i = 0; i < values.size(); ++i) {
-    values[i] += other[i];
-  }
+  kernel::Get().Add(values.data(), other.values.data(), values.size());
 }
 
 bool Tensor::operator==(const Tensor& other) const {
@@ -42,20 +56,13 @@ bool Tensor::operator!=(const Tensor& other) const {
 }
 
 float Tensor::Error() {
-  float ret = 0.f;
-  for (const auto i : values) {
-    ret += i * i;
-  }
-  return ret;
+  return kernel::Get().SquareSum(values.data(), values.size());
 }
 
 size_t Tensor::ArgMax() {
-  size_t i_max = 0;
-  for (size_t i = 1; i < values.size(); ++i) {
-    if (values[i] > values[i_max])
-      i_max = i;
-  }
-  return i_max;
+  if (values.empty())
+    return 0;
+  return kernel::Get().ArgMax(values.data(), values.size());
 }
 
 std::string Tensor::ToString() {
@@ -71,14 +78,14 @@ std::string Tensor::ToString() {
 }
 
 // static
-Tensor Tensor::Random(const std::vector<size_t>& sizes) {
+Tensor Tensor::Random(const Shape& sizes) {
   Tensor tensor(sizes);
   tensor.Randomize();
   return tensor;
 }
 
 // static
-Tensor Tensor::SphericalRandom(const std::vector<size_t>& sizes) {
+Tensor Tensor::SphericalRandom(const Shape& sizes) {
   Tensor tensor = Tensor::Random(sizes);
   float XX = 0.f;
   for (auto x : tensor.values) {
@@ -92,17 +99,11 @@ Tensor Tensor::SphericalRandom(const std::vector<size_t>& sizes) {
 }
 
 void Tensor::Randomize() {
-  static std::mt19937 rng;
-  std::normal_distribution<float> random(0.0, 1.0);
-  for (auto& i : values)
-    i = random(rng);
+  Random::Global().Normal(values.data(), values.size());
 }
 
 void Tensor::UniformRandom() {
-  static std::mt19937 rng;
-  std::uniform_real_distribution<float> random(0.0, 1.0);
-  for (auto& i : values)
-    i = random(rng);
+  Random::Global().Uniform(values.data(), values.size());
 }
 
 float& Tensor::at(size_t x, size_t y) {
@@ -119,7 +120,12 @@ float Tensor::at(size_t x, size_t y, size_t z) const {
 }
 
 // static
-Tensor Tensor::Merge(std::vector<Tensor> tensors, int dim_x) {
+Tensor Tensor::Merge(const std::vector<Tensor>& tensors, int dim_x) {
+  return Merge(std::vector<TensorView>(tensors.begin(), tensors.end()), dim_x);
+}
+
+// static
+Tensor Tensor::Merge(const std::vector<TensorView>& tensors, int dim_x) {
   size_t dx = dim_x ? dim_x : std::sqrt(tensors.size());
   size_t dy = (tensors.size()+dx-1) / dx;
   //size_t dx = tensors.size();
@@ -150,30 +156,24 @@ Tensor Tensor::Merge(std::vector<Tensor> tensors, int dim_x) {
 }
 
 void Tensor::Clip(const float c) {
-  for (auto& v : values)
-    v = std::min(c, std::max(-c, v));
+  kernel::Get().Clip(values.data(), values.size(), -c, c);
 }
 
 void Tensor::Clip(const float v_min, const float v_max) {
-  for (auto& v : values)
-    v = std::min(v_max, std::max(v_min, v));
+  kernel::Get().Clip(values.data(), values.size(), v_min, v_max);
 }
 
 void Tensor::Rescale(const float min, const float max) {
-  float input_min = values[0];
-  float input_max = values[0];
-  for(const auto& v : values) {
-    input_min = std::min(input_min, v);
-    input_max = std::max(input_max, v);
-  }
-
-  for(auto& v : values) {
-    v = (v - input_min) * (max - min) / (input_max - input_min) + min;
-  }
+  const kernel::Table& k = kernel::Get();
+  float input_min, input_max;
+  k.MinMax(values.data(), values.size(), &input_min, &input_max);
+  k.Affine(values.data(), values.size(), input_min,
+           (max - min) / (input_max - input_min), min);
 }
 
 //static
-Tensor Tensor::ConcatenateHorizontal(const Tensor& A, const Tensor& B) {
+Tensor Tensor::ConcatenateHorizontal(const TensorView& A,
+                                     const TensorView& B) {
   const size_t width_A = A.sizes[0];
   const size_t width_B = B.sizes[0];
   const size_t height_A = A.sizes[1];
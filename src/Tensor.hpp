@@ -3,22 +3,41 @@
 
 #include <string>
 #include <vector>
+#include "Storage.hpp"
 #include "util.hpp"
 
 using std::size_t;
 
 class Node;
+struct TensorView;
+namespace expression {
+template <class Derived>
+struct Expression;
+}  // namespace expression
 
 struct Tensor {
-  std::vector<float> values;
-  std::vector<size_t> sizes;
+  Storage values;
+  Shape sizes;
 
   Tensor();
   Tensor(size_t size);
-  Tensor(const std::vector<size_t>& sizes);
+  Tensor(const Shape& sizes);
 
-  static Tensor Random(const std::vector<size_t>& sizes);
-  static Tensor SphericalRandom(const std::vector<size_t>& sizes);
+  // Copy the values of a view.
+  Tensor(const TensorView& view);
+  Tensor& operator=(const TensorView& view);
+
+  // Evaluate an expression in a single pass. See TensorExpression.hpp.
+  template <class E>
+  Tensor(const expression::Expression<E>& e);
+  template <class E>
+  Tensor& operator=(const expression::Expression<E>& e);
+
+  // A Tensor viewing memory owned by someone else. See Storage::View.
+  static Tensor View(const Shape& sizes, float* data);
+
+  static Tensor Random(const Shape& sizes);
+  static Tensor SphericalRandom(const Shape& sizes);
 
   std::string ToString();
   void Fill(float value);
@@ -35,18 +54,21 @@ struct Tensor {
   void Clip(const float min, const float max);
 
   void Rescale(const float min = 0.f, const float max = 255.f);
-  static Tensor ConcatenateHorizontal(const Tensor& A, const Tensor& B);
+  static Tensor ConcatenateHorizontal(const TensorView& A,
+                                      const TensorView& B);
 
   // Operators.
   void operator*=(float lambda);
   void operator+=(const Tensor& other);
+  template <class E>
+  void operator+=(const expression::Expression<E>& e);
   float& operator[](size_t i) { return values[i]; }
   const float& operator[](size_t i) const { return values[i]; }
-  Tensor operator-(const Tensor& tensor) const;
   bool operator==(const Tensor& other) const;
   bool operator!=(const Tensor& other) const;
 
-  static Tensor Merge(std::vector<Tensor> tensors, int dim_x = 0);
+  static Tensor Merge(const std::vector<TensorView>& tensors, int dim_x = 0);
+  static Tensor Merge(const std::vector<Tensor>& tensors, int dim_x = 0);
 };
 
 #endif /* end of include guard: TENSOR_H */
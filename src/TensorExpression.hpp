@@ -0,0 +1,226 @@
+#ifndef TENSOR_EXPRESSION_H
+#define TENSOR_EXPRESSION_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "Tensor.hpp"
+#include "TensorView.hpp"
+
+// Lazy elementwise arithmetic on Tensor.
+//
+// An expression like |(a - b) * 0.5f| doesn't compute anything. It only
+// records the operations. The values are computed in a single pass when the
+// expression is assigned to a Tensor, or reduced by Error(). No temporary
+// Tensor is ever allocated, and each input is read exactly once:
+//
+//   derivative = current - target;          // One pass, no allocation.
+//   float error = (output - target).Error(); // One pass, no allocation.
+//
+// Expressions hold pointers to the values of their operands. They must not
+// outlive them.
+namespace expression {
+
+template <class E>
+struct Clipped;
+
+template <class Derived>
+struct Expression {
+  const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+  // Sum of the squared values. See Tensor::Error().
+  float Error() const {
+    const Derived& e = self();
+    const size_t size = e.size();
+    float ret = 0.f;
+    for (size_t i = 0; i < size; ++i) {
+      const float v = e[i];
+      ret += v * v;
+    }
+    return ret;
+  }
+
+  Clipped<Derived> Clip(float c) const { return Clip(-c, c); }
+  Clipped<Derived> Clip(float min, float max) const {
+    return Clipped<Derived>(self(), min, max);
+  }
+
+  // Evaluate into |destination|, which must hold size() values.
+  void EvaluateTo(float* destination) const {
+    const Derived& e = self();
+    const size_t size = e.size();
+    for (size_t i = 0; i < size; ++i)
+      destination[i] = e[i];
+  }
+};
+
+// A contiguous array of values: a Tensor or a contiguous TensorView.
+struct Leaf : Expression<Leaf> {
+  const float* data;
+  Shape sizes;
+
+  Leaf(const float* data, const Shape& sizes) : data(data), sizes(sizes) {}
+  size_t size() const { return sizes.Elements(); }
+  const Shape& shape() const { return sizes; }
+  float operator[](size_t i) const { return data[i]; }
+};
+
+// Tells whether a type can be used as an operand, and how.
+template <class T, class = void>
+struct Operand {
+  static constexpr bool value = false;
+};
+
+template <class T>
+struct Operand<T,
+               typename std::enable_if<
+                   std::is_base_of<Expression<T>, T>::value>::type> {
+  static constexpr bool value = true;
+  using Type = T;
+  static const T& Get(const T& expression) { return expression; }
+};
+
+template <>
+struct Operand<Tensor> {
+  static constexpr bool value = true;
+  using Type = Leaf;
+  static Leaf Get(const Tensor& tensor) {
+    return Leaf(tensor.values.data(), tensor.sizes);
+  }
+};
+
+template <>
+struct Operand<TensorView> {
+  static constexpr bool value = true;
+  using Type = Leaf;
+  static Leaf Get(const TensorView& view) {
+    if (!view.IsContiguous())
+      throw std::invalid_argument("Expression: the view must be contiguous");
+    return Leaf(view.data, view.sizes);
+  }
+};
+
+template <class T>
+using OperandType = typename Operand<typename std::decay<T>::type>::Type;
+
+template <class E>
+OperandType<E> AsExpression(const E& e) {
+  return Operand<typename std::decay<E>::type>::Get(e);
+}
+
+struct Add {
+  static float Apply(float a, float b) { return a + b; }
+};
+struct Sub {
+  static float Apply(float a, float b) { return a - b; }
+};
+
+template <class Op, class L, class R>
+struct Binary : Expression<Binary<Op, L, R>> {
+  L left;
+  R right;
+
+  Binary(const L& left, const R& right) : left(left), right(right) {
+    if (left.size() != right.size())
+      throw std::invalid_argument("Expression: sizes don't match");
+  }
+  size_t size() const { return left.size(); }
+  const Shape& shape() const { return left.shape(); }
+  float operator[](size_t i) const { return Op::Apply(left[i], right[i]); }
+};
+
+template <class E>
+struct Scaled : Expression<Scaled<E>> {
+  E e;
+  float lambda;
+
+  Scaled(const E& e, float lambda) : e(e), lambda(lambda) {}
+  size_t size() const { return e.size(); }
+  const Shape& shape() const { return e.shape(); }
+  float operator[](size_t i) const { return lambda * e[i]; }
+};
+
+template <class E>
+struct Clipped : Expression<Clipped<E>> {
+  E e;
+  float min;
+  float max;
+
+  Clipped(const E& e, float min, float max) : e(e), min(min), max(max) {}
+  size_t size() const { return e.size(); }
+  const Shape& shape() const { return e.shape(); }
+  float operator[](size_t i) const {
+    return std::min(max, std::max(min, e[i]));
+  }
+};
+
+template <class L, class R>
+using EnableIfOperands = typename std::enable_if<
+    Operand<typename std::decay<L>::type>::value &&
+    Operand<typename std::decay<R>::type>::value>::type;
+
+template <class E>
+using EnableIfOperand =
+    typename std::enable_if<Operand<typename std::decay<E>::type>::value>::type;
+
+}  // namespace expression
+
+template <class L, class R, class = expression::EnableIfOperands<L, R>>
+expression::Binary<expression::Add,
+                   expression::OperandType<L>,
+                   expression::OperandType<R>>
+operator+(const L& left, const R& right) {
+  return {expression::AsExpression(left), expression::AsExpression(right)};
+}
+
+template <class L, class R, class = expression::EnableIfOperands<L, R>>
+expression::Binary<expression::Sub,
+                   expression::OperandType<L>,
+                   expression::OperandType<R>>
+operator-(const L& left, const R& right) {
+  return {expression::AsExpression(left), expression::AsExpression(right)};
+}
+
+template <class E, class = expression::EnableIfOperand<E>>
+expression::Scaled<expression::OperandType<E>> operator*(const E& e,
+                                                         float lambda) {
+  return {expression::AsExpression(e), lambda};
+}
+
+template <class E, class = expression::EnableIfOperand<E>>
+expression::Scaled<expression::OperandType<E>> operator*(float lambda,
+                                                         const E& e) {
+  return {expression::AsExpression(e), lambda};
+}
+
+template <class E>
+Tensor::Tensor(const expression::Expression<E>& e)
+    : Tensor(e.self().shape()) {
+  e.EvaluateTo(values.data());
+}
+
+template <class E>
+Tensor& Tensor::operator=(const expression::Expression<E>& e) {
+  // Every operand has the same size as the expression. When the size
+  // changes, the destination can't be an operand, so it can be reallocated.
+  const size_t size = e.self().size();
+  if (values.size() != size) {
+    if (values.IsView())
+      throw std::invalid_argument("Tensor: size doesn't match the view");
+    values = Storage(size);
+  }
+  sizes = e.self().shape();
+  e.EvaluateTo(values.data());
+  return *this;
+}
+
+template <class E>
+void Tensor::operator+=(const expression::Expression<E>& e) {
+  if (values.size() != e.self().size())
+    throw std::invalid_argument("Tensor: sizes don't match");
+  const E& self = e.self();
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] += self[i];
+}
+
+#endif /* end of include guard: TENSOR_EXPRESSION_H */
@@ -0,0 +1,36 @@
+#include "gtest/gtest.h"
+
+#include "Pool.hpp"
+#include "TensorExpression.hpp"
+
+TEST(TensorExpression, Evaluate) {
+  Tensor a({4});
+  Tensor b({4});
+  a.values = {1.f, 2.f, 3.f, 4.f};
+  b.values = {4.f, 3.f, 2.f, 1.f};
+
+  Tensor c = (a - b) * 2.f;
+  EXPECT_EQ(c.values, Storage({-6.f, -2.f, 2.f, 6.f}));
+
+  c = (a + b + c).Clip(4.f);
+  EXPECT_EQ(c.values, Storage({-1.f, 3.f, 4.f, 4.f}));
+
+  EXPECT_EQ((a - b).Error(), 9.f + 1.f + 1.f + 9.f);
+  EXPECT_THROW(Tensor(a - Tensor({3})), std::invalid_argument);
+}
+
+TEST(TensorExpression, NoAllocation) {
+  Tensor a = Tensor::Random({100});
+  Tensor b = Tensor::Random({100});
+  Tensor c({100});
+
+  // With an empty pool, any temporary would hit the system.
+  Pool::Clear();
+  const size_t allocations = Pool::Allocations();
+  for (int i = 0; i < 10; ++i) {
+    c = 0.5f * (a - b) + c;
+    c.Error();
+    (c - a).Error();
+  }
+  EXPECT_EQ(Pool::Allocations(), allocations);
+}
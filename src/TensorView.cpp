@@ -0,0 +1,46 @@
+#include "TensorView.hpp"
+#include <algorithm>
+
+namespace {
+
+Shape ContiguousStrides(const Shape& sizes) {
+  Shape strides = sizes;
+  size_t stride = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    strides[i] = stride;
+    stride *= sizes[i];
+  }
+  return strides;
+}
+
+}  // namespace
+
+TensorView::TensorView(const Tensor& tensor)
+    : TensorView(tensor.values.data(), tensor.sizes) {}
+
+TensorView::TensorView(const float* data, const Shape& sizes)
+    : TensorView(data, sizes, ContiguousStrides(sizes)) {}
+
+TensorView::TensorView(const float* data,
+                       const Shape& sizes,
+                       const Shape& strides)
+    : data(data), sizes(sizes), strides(strides) {}
+
+bool TensorView::IsContiguous() const {
+  return strides == ContiguousStrides(sizes);
+}
+
+TensorView TensorView::Slice(size_t dim, size_t begin, size_t size) const {
+  TensorView view = *this;
+  view.data += begin * strides[dim];
+  view.sizes[dim] = size;
+  return view;
+}
+
+void TensorView::CopyTo(float* destination) const {
+  if (IsContiguous()) {
+    std::copy(data, data + Elements(), destination);
+    return;
+  }
+  ForEach([&destination](float value) { *(destination++) = value; });
+}
@@ -0,0 +1,74 @@
+#ifndef TENSOR_VIEW_H
+#define TENSOR_VIEW_H
+
+#include "Shape.hpp"
+#include "Tensor.hpp"
+
+// A read-only view on the values of a Tensor, or on a part of it.
+//
+// It is only a pointer, a shape and a stride per dimension, so sub-batches,
+// channels or tiles can be addressed without copying anything. A view doesn't
+// own its values: it must not outlive the Tensor or Batch it refers to.
+struct TensorView {
+  const float* data = nullptr;
+  Shape sizes;
+  Shape strides;
+
+  TensorView() = default;
+  TensorView(const Tensor& tensor);
+  TensorView(const float* data, const Shape& sizes);
+  TensorView(const float* data, const Shape& sizes, const Shape& strides);
+
+  size_t Elements() const { return sizes.Elements(); }
+  bool IsContiguous() const;
+
+  // Flat access. Only meaningful for a contiguous view.
+  float operator[](size_t i) const { return data[i]; }
+
+  float at(size_t x, size_t y) const {
+    return data[x * strides[0] + y * strides[1]];
+  }
+  float at(size_t x, size_t y, size_t z) const {
+    return data[x * strides[0] + y * strides[1] + z * strides[2]];
+  }
+
+  // Restrict the dimension |dim| to the range [begin, begin + size).
+  TensorView Slice(size_t dim, size_t begin, size_t size) const;
+
+  // Copy the values, in row-major order, into |destination|.
+  void CopyTo(float* destination) const;
+
+  // Call |f| with every value, in row-major order.
+  template <class F>
+  void ForEach(F f) const;
+};
+
+template <class F>
+void TensorView::ForEach(F f) const {
+  if (IsContiguous()) {
+    const size_t elements = Elements();
+    for (size_t i = 0; i < elements; ++i)
+      f(data[i]);
+    return;
+  }
+
+  // Walk the dimensions as if there were always |max_rank| of them.
+  size_t s[Shape::max_rank] = {1, 1, 1, 1};
+  size_t d[Shape::max_rank] = {0, 0, 0, 0};
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    s[i] = sizes[i];
+    d[i] = strides[i];
+  }
+
+  // clang-format off
+  for(size_t i3 = 0; i3 < s[3]; ++i3)
+  for(size_t i2 = 0; i2 < s[2]; ++i2)
+  for(size_t i1 = 0; i1 < s[1]; ++i1) {
+    const float* row = data + i1 * d[1] + i2 * d[2] + i3 * d[3];
+    for(size_t i0 = 0; i0 < s[0]; ++i0)
+      f(row[i0 * d[0]]);
+  }
+  // clang-format on
+}
+
+#endif /* end of include guard: TENSOR_VIEW_H */
@@ -0,0 +1,36 @@
+#include "gtest/gtest.h"
+
+#include "Batch.hpp"
+#include "TensorView.hpp"
+
+TEST(TensorView, Slice) {
+  Tensor tensor({3, 2});
+  tensor.values = {0.f, 1.f, 2.f,  //
+                   3.f, 4.f, 5.f};
+
+  TensorView column = TensorView(tensor).Slice(0, 1, 2);
+  EXPECT_FALSE(column.IsContiguous());
+  EXPECT_EQ(column.at(0, 1), 4.f);
+
+  Tensor copy = column;
+  EXPECT_EQ(copy.sizes, Shape({2, 2}));
+  EXPECT_EQ(copy.values, Storage({1.f, 2.f, 4.f, 5.f}));
+}
+
+TEST(TensorView, Batch) {
+  Batch batch(4, {2});
+  for (size_t i = 0; i < batch.size(); ++i)
+    batch[i].values = {float(i), float(10 * i)};
+
+  // The samples [1, 3) seen as a single 2x2 tensor, without copy.
+  TensorView view = batch.View(1, 2);
+  EXPECT_EQ(view.data, batch[1].values.data());
+  EXPECT_TRUE(view.IsContiguous());
+  EXPECT_EQ(Tensor(view).values, Storage({1.f, 10.f, 2.f, 20.f}));
+
+  // Merging views doesn't copy the inputs.
+  Tensor merge = Tensor::Merge(
+      std::vector<TensorView>(batch.begin(), batch.end()), 4);
+  EXPECT_EQ(merge.sizes, Shape({8, 1, 1}));
+  EXPECT_EQ(merge.at(6, 0, 0), 3.f);
+}
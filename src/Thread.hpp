@@ -0,0 +1,36 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using std::size_t;
+
+// The threads running the "#pragma omp parallel" loops. Without OpenMP,
+// everything runs on a single thread.
+namespace Thread {
+
+// Number of threads a parallel loop may use.
+inline size_t Count() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+// Index of the calling thread within its parallel loop, in [0, Count()).
+inline size_t Index() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+}  // namespace Thread
+
+#endif /* end of include guard: THREAD_H */
@@ -0,0 +1,103 @@
+#include "Tracer.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include "node/Node.hpp"
+
+namespace {
+
+Tracer* active_tracer = nullptr;
+
+std::atomic<size_t> next_serial(1);
+std::atomic<size_t> next_thread_id(0);
+
+// The lane of the calling thread, the same for every tracer. The OpenMP
+// thread number is only unique within one parallel region.
+size_t ThreadId() {
+  thread_local size_t id = next_thread_id++;
+  return id;
+}
+
+}  // namespace
+
+Tracer::Tracer()
+    : serial_(next_serial++), origin_(std::chrono::steady_clock::now()) {}
+
+std::vector<Tracer::Event>& Tracer::Events() {
+  // The list of the thread is looked up once per tracer.
+  thread_local size_t serial = 0;
+  thread_local std::vector<Event>* events = nullptr;
+  if (serial != serial_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back({ThreadId(), {}});
+    events = &threads_.back().events;
+    serial = serial_;
+  }
+  return *events;
+}
+
+// static
+Tracer* Tracer::Active() {
+  return active_tracer;
+}
+
+// static
+void Tracer::SetActive(Tracer* tracer) {
+  active_tracer = tracer;
+}
+
+Tracer::Span::Span(const char* name, const char* category)
+    : tracer(active_tracer), name(name), node(nullptr), category(category) {
+  if (tracer)
+    start = std::chrono::steady_clock::now();
+}
+
+Tracer::Span::Span(const Node* node, const char* category)
+    : tracer(active_tracer), name(nullptr), node(node), category(category) {
+  if (tracer)
+    start = std::chrono::steady_clock::now();
+}
+
+Tracer::Span::~Span() {
+  if (!tracer)
+    return;
+  const auto end = std::chrono::steady_clock::now();
+  using microseconds = std::chrono::duration<double, std::micro>;
+  tracer->Events().push_back({
+      node ? node->Name() : std::string(name),
+      category,
+      microseconds(start - tracer->origin_).count(),
+      microseconds(end - start).count(),
+  });
+}
+
+size_t Tracer::size() const {
+  size_t size = 0;
+  for (const ThreadEvents& thread : threads_)
+    size += thread.events.size();
+  return size;
+}
+
+std::string Tracer::ToJSON() const {
+  std::string json = "{\"traceEvents\":[";
+  bool first = true;
+  char line[512];
+  for (const ThreadEvents& thread : threads_) {
+    for (const Event& event : thread.events) {
+      std::snprintf(line, sizeof(line),
+                    "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                    "\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%zu}",
+                    first ? "" : ",", event.name.c_str(), event.category,
+                    event.start, event.duration, thread.id);
+      json += line;
+      first = false;
+    }
+  }
+  json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return json;
+}
+
+void Tracer::WriteToFile(const std::string& filename) const {
+  std::ofstream file(filename);
+  file << ToJSON();
+}
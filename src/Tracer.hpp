@@ -0,0 +1,81 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Node;
+
+// Records timed spans, per thread, and writes them in the Chrome trace event
+// format. The file opens in chrome://tracing or ui.perfetto.dev, and shows
+// how the work of a training step spreads over the threads. See
+// Model::TraceToFile().
+//
+// Each system thread gets its own lane: the spans of nested or successive
+// parallel regions running on different threads don't share one.
+//
+// Spans go to the active tracer, if any. Without one, a Span only checks a
+// pointer.
+class Tracer {
+ public:
+  Tracer();
+
+  // The tracer receiving the spans, or null. Only to be changed outside of
+  // the parallel loops.
+  static Tracer* Active();
+  static void SetActive(Tracer* tracer);
+
+  // Measure the lifetime of the Span, on the calling thread.
+  class Span {
+   public:
+    Span(const char* name, const char* category);
+    // Named after the type of |node|.
+    Span(const Node* node, const char* category);
+    ~Span();
+
+   private:
+    Tracer* tracer;
+    const char* name;
+    const Node* node;
+    const char* category;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // Number of recorded spans.
+  size_t size() const;
+
+  // The trace, as JSON.
+  std::string ToJSON() const;
+  void WriteToFile(const std::string& filename) const;
+
+ private:
+  struct Event {
+    std::string name;
+    const char* category;
+    // Microseconds since the creation of the tracer.
+    double start;
+    double duration;
+  };
+
+  // The events of the calling thread.
+  std::vector<Event>& Events();
+
+  struct ThreadEvents {
+    // The lane of the thread in the trace.
+    size_t id;
+    std::vector<Event> events;
+  };
+
+  // One list per thread, added by the thread on its first span. Each thread
+  // only appends to its own.
+  std::deque<ThreadEvents> threads_;
+  std::mutex mutex_;
+  // Distinguishes this tracer from the previous ones, see Events().
+  size_t serial_;
+  std::chrono::steady_clock::time_point origin_;
+};
+
+#endif /* end of include guard: TRACER_H */
@@ -1,6 +1,7 @@
 #include "algorithm/WCGAN.hpp"
 #include <iomanip>
 #include <iostream>
+#include <utility>
 #include "Model.hpp"
 
 void WCGAN::Init() {
@@ -24,28 +25,42 @@ void WCGAN::Train() {
   Range(generator_input_, discriminator_output_).Apply(&Node::Clear);
 
   // Generate instances from the latent distribution.
-  std::vector<Example> examples;
+  Tensor target({1});
+  target.values = {1.f};
+  std::vector<Example> examples(batch_size, {Tensor(latent_size), target});
+  const uint64_t current_step = step_++;
+  #pragma omp parallel for
   for (int i = 0; i < batch_size; ++i) {
-    auto input = Tensor::Random(latent_size);
-    auto output = Tensor({1});
-    output.values = {1.0};
-    examples.push_back({input, output});
+    Tensor& latent = examples[i].input;
+    Random(random_key_, current_step, i)
+        .Normal(latent.values.data(), latent.values.size());
   }
 
   // Train the generator;
+  const size_t generator_examples = examples.size();
   auto model_train_generator =
-      Model(generator_input_, discriminator_output_, examples);
+      Model(generator_input_, discriminator_output_, std::move(examples));
   model_train_generator.loss_function = LossFunction::WasserStein;
 
+  // The generated instances are written directly into the examples of the
+  // discriminator. They are copied only once, out of the generator's output.
+  std::vector<Example> discriminator_examples;
+  Tensor real_output({1});
+  Tensor fake_output({1});
+  real_output.values = {1.f};
+  fake_output.values = {-1.f};
+
+  const size_t capacity = generator_input_->capacity();
   float error = 0.f;
-  std::vector<Tensor> generated;
-  for (size_t i = 0; i < examples.size(); i += Node::T) {
-    model_train_generator.Train(learning_rate, examples.size());
-    generated.insert(generated.end(), generator_output_->output.begin(),
-                     generator_output_->output.end());
+  for (size_t i = 0; i < generator_examples; i += capacity) {
+    model_train_generator.Train(learning_rate, generator_examples);
+    for (const Tensor& generated : generator_output_->output) {
+      discriminator_examples.push_back(Example{input(), real_output});
+      discriminator_examples.push_back(Example{generated, fake_output});
+    }
     error += model_train_generator.LastError();
   }
-  float generative_error = Node::T * error / examples.size();
+  float generative_error = capacity * error / generator_examples;
 
   //---------------------------------------------------------------------------
   // Train the discriminator
@@ -55,20 +70,11 @@ void WCGAN::Train() {
   Range(discriminator_input_, discriminator_output_).Apply(&Node::Unlock);
   Range(discriminator_input_, discriminator_output_).Apply(&Node::Clear);
 
-  examples.clear();
-  for (size_t i = 0; i < generated.size(); ++i) {
-    auto output = Tensor({1});
-
-    output.values = {1.f};
-    examples.push_back(Example{input(), output});
-
-    output.values = {-1.f};
-    examples.push_back(Example{generated[i], output});
-  }
-
   // Train the network.
+  const size_t discriminator_size = discriminator_examples.size();
   auto model_train_discriminator =
-      Model(discriminator_input_, discriminator_output_, examples);
+      Model(discriminator_input_, discriminator_output_,
+            std::move(discriminator_examples));
   model_train_discriminator.loss_function = LossFunction::WasserStein;
   //model_train_discriminator.post_update_function =
       //PostUpdateFunction::ClipWeight(discriminator_input_->next,
@@ -79,7 +85,7 @@ void WCGAN::Train() {
 
   // std::shuffle(input.begin(), input.end(), random_generator);
   for(int i = 0; i<10; ++i) {
-    model_train_discriminator.Train(learning_rate, examples.size());
+    model_train_discriminator.Train(learning_rate, discriminator_size);
   }
   float discriminative_error = model_train_discriminator.LastError();
 
@@ -2,8 +2,8 @@
 #define WEBNEURAL_ALGORITHM_WCGAN
 
 #include <functional>
-#include <random>
 #include "Allocator.hpp"
+#include "Random.hpp"
 
 class WCGAN {
  public:
@@ -32,7 +32,9 @@ class WCGAN {
   Node* discriminator_input_ = nullptr;
   Node* discriminator_output_ = nullptr;
 
-  std::random_device random;
+  // The latent samples of the |step_|-th training step.
+  uint64_t random_key_ = Random::NewKey();
+  uint64_t step_ = 0;
 };
 
 #endif /* end of include guard: WEBNEURAL_ALGORITHM_WCGAN */
@@ -1,6 +1,8 @@
 #include "Allocator.hpp"
 #include "Image.hpp"
+#include "IncrementalPredictor.hpp"
 #include "Model.hpp"
+#include "PredictionCache.hpp"
 #include "mnist/mnist_reader.hpp"
 #include <chrono>
 #include <cmath>
@@ -66,8 +68,15 @@ auto output = decompress(latent);
 
 Model model(input, output, training_set);
 
+// The sliders move one coordinate of the latent vector at a time, and often
+// come back to the same values.
+PredictionCache cache(256, 1e-3f);
+IncrementalPredictor predictor(latent, output);
+
 void Train(float lambda, int iterations = 10) {
   model.Train(lambda, iterations);
+  predictor.Reset();
+  cache.Clear();
 }
 
 void Import(Tensor& tensor, double* input) {
@@ -87,7 +96,11 @@ void Export(const Tensor& tensor, uint8_t* output) {
 }
 
 void Save() { model.SerializeParamsToFile("save.bin"); }
-void Load() { model.DeserializeParamsFromFile("save.bin"); }
+void Load() {
+  model.DeserializeParamsFromFile("save.bin");
+  predictor.Reset();
+  cache.Clear();
+}
 
 extern "C" {
 
@@ -106,11 +119,12 @@ void LastOutput(uint8_t* _output) {
 }
 
 void Predict(double* _input, uint8_t* _output) {
-  Import(latent->output[0], _input);
-  Range(latent->next, output).Apply([](Node* node) {
-    node->Forward(1);
-  });
-  Export(output->output[0], _output);
+  Tensor value(latent->output[0].sizes);
+  Import(value, _input);
+  const Tensor* prediction = cache.Find(value);
+  if (!prediction)
+    prediction = &cache.Insert(value, predictor.Predict(value));
+  Export(*prediction, _output);
 }
 
 void LoadPretrainedModel() {
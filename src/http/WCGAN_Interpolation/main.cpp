@@ -5,7 +5,9 @@
 #include <random>
 #include "Allocator.hpp"
 #include "Image.hpp"
+#include "IncrementalPredictor.hpp"
 #include "Model.hpp"
+#include "PredictionCache.hpp"
 #include "mnist/mnist_reader.hpp"
 
 std::random_device seed;
@@ -95,6 +97,11 @@ void Export(const Tensor& tensor, uint8_t* output) {
 
 Model model(generator_input, generator_output);
 
+// The sliders move one coordinate of the latent vector at a time, and often
+// come back to the same values.
+PredictionCache cache(256, 1e-3f);
+IncrementalPredictor predictor(generator_input, generator_output);
+
 float learning_rate = 0.0002f;
 
 std::vector<float> SaveModelToVector() {
@@ -110,6 +117,8 @@ void LoadModelFromString(const std::vector<float>& data) {
   Node::Link(generator_output, discriminator_input->next);
   Model model(generator_input, discriminator_output);
   model.DeserializeParams(data);
+  predictor.Reset();
+  cache.Clear();
 }
 
 void Load() {
@@ -118,6 +127,8 @@ void Load() {
   Model model(generator_input, discriminator_output);
   model.DeserializeParamsFromFile("save.bin");
   learning_rate = 0.0002f;
+  predictor.Reset();
+  cache.Clear();
 }
 
 //void Save() { model.SerializeParamsToFile("save.bin"); }
@@ -125,11 +136,12 @@ void Load() {
 extern "C" {
 
 void Predict(double* _input, uint8_t* _output) {
-  Import(generator_input->output[0], _input);
-  Range(generator_input->next, generator_output).Apply([](Node* node) {
-    node->Forward(1);
-  });
-  Export(generator_output->output[0], _output);
+  Tensor value(generator_input->output[0].sizes);
+  Import(value, _input);
+  const Tensor* prediction = cache.Find(value);
+  if (!prediction)
+    prediction = &cache.Insert(value, predictor.Predict(value));
+  Export(*prediction, _output);
 }
 
 void LoadPretrainedModel() {
@@ -142,6 +154,8 @@ void ResetModelWeight() {
 };
 
 void Train() {
+  predictor.Reset();
+  cache.Clear();
   std::vector<Example> examples;
 
   std::vector<Tensor> generated;
@@ -0,0 +1,127 @@
+#include "kernel/Kernel.hpp"
+
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+
+#include <immintrin.h>
+#include "kernel/Generic.hpp"
+
+namespace kernel {
+
+namespace {
+
+struct V {
+  using Type = __m256;
+  static constexpr size_t width = 8;
+
+  static Type Zero() { return _mm256_setzero_ps(); }
+  static Type Set(float v) { return _mm256_set1_ps(v); }
+  static Type Load(const float* p) { return _mm256_loadu_ps(p); }
+  static void Store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+  static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+  static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+  static Type MulAdd(Type a, Type b, Type c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+  static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+
+  // Combine the 8 lanes with |op|, which operates on 4 lanes.
+  template <class Op>
+  static float Reduce(Type v, Op op) {
+    __m128 r = op(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    r = op(r, _mm_movehl_ps(r, r));
+    r = op(r, _mm_shuffle_ps(r, r, 0x55));
+    return _mm_cvtss_f32(r);
+  }
+  static float ReduceAdd(Type v) {
+    return Reduce(v, [](__m128 a, __m128 b) { return _mm_add_ps(a, b); });
+  }
+  static float ReduceMin(Type v) {
+    return Reduce(v, [](__m128 a, __m128 b) { return _mm_min_ps(a, b); });
+  }
+  static float ReduceMax(Type v) {
+    return Reduce(v, [](__m128 a, __m128 b) { return _mm_max_ps(a, b); });
+  }
+};
+
+// Round the floats to their upper 16 bits, to nearest even. See Scalar.cpp.
+__m256i RoundToBFloat16(__m256 v) {
+  __m256i bits = _mm256_castps_si256(v);
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+  bits = _mm256_or_si256(bits,
+                         _mm256_and_si256(nan, _mm256_set1_epi32(0x00400000)));
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  bits = _mm256_add_epi32(bits,
+                          _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+  return _mm256_srli_epi32(bits, 16);
+}
+
+void ToBFloat16(const float* input, uint16_t* output, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i a = RoundToBFloat16(_mm256_loadu_ps(input + i));
+    const __m256i b = RoundToBFloat16(_mm256_loadu_ps(input + i + 8));
+    // The packing works within each 128 bits lane. Put the lanes back in
+    // order.
+    const __m256i packed =
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+  }
+  Scalar()->ToBFloat16(input + i, output + i, size - i);
+}
+
+void FromBFloat16(const uint16_t* input, float* output, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m256i v = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)));
+    _mm256_storeu_ps(output + i, _mm256_castsi256_ps(_mm256_slli_epi32(v, 16)));
+  }
+  Scalar()->FromBFloat16(input + i, output + i, size - i);
+}
+
+void ToFloat16(const float* input, uint16_t* output, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v = _mm256_cvtps_ph(_mm256_loadu_ps(input + i),
+                                      _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), v);
+  }
+  Scalar()->ToFloat16(input + i, output + i, size - i);
+}
+
+void FromFloat16(const uint16_t* input, float* output, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    _mm256_storeu_ps(output + i, _mm256_cvtph_ps(v));
+  }
+  Scalar()->FromFloat16(input + i, output + i, size - i);
+}
+
+}  // namespace
+
+const Table* AVX2() {
+  static const Table table = [] {
+    Table table = generic::Kernels<V>::MakeTable("AVX2");
+    table.ToBFloat16 = ToBFloat16;
+    table.FromBFloat16 = FromBFloat16;
+    table.ToFloat16 = ToFloat16;
+    table.FromFloat16 = FromFloat16;
+    return table;
+  }();
+  return &table;
+}
+
+}  // namespace kernel
+
+#else
+
+const kernel::Table* kernel::AVX2() {
+  return nullptr;
+}
+
+#endif
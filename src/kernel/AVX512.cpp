@@ -0,0 +1,114 @@
+#include "kernel/Kernel.hpp"
+
+#if defined(__AVX512F__)
+
+// GCC 12 warns about _mm512_undefined_ps(), used internally by the
+// intrinsics.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+#include "kernel/Generic.hpp"
+
+namespace kernel {
+
+namespace {
+
+struct V {
+  using Type = __m512;
+  static constexpr size_t width = 16;
+
+  static Type Zero() { return _mm512_setzero_ps(); }
+  static Type Set(float v) { return _mm512_set1_ps(v); }
+  static Type Load(const float* p) { return _mm512_loadu_ps(p); }
+  static void Store(float* p, Type v) { _mm512_storeu_ps(p, v); }
+  static Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+  static Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+  static Type MulAdd(Type a, Type b, Type c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static Type Min(Type a, Type b) { return _mm512_min_ps(a, b); }
+  static Type Max(Type a, Type b) { return _mm512_max_ps(a, b); }
+  static float ReduceAdd(Type v) { return _mm512_reduce_add_ps(v); }
+  static float ReduceMin(Type v) { return _mm512_reduce_min_ps(v); }
+  static float ReduceMax(Type v) { return _mm512_reduce_max_ps(v); }
+};
+
+// Round the floats to their upper 16 bits, to nearest even. See Scalar.cpp.
+__m512i RoundToBFloat16(__m512 v) {
+  __m512i bits = _mm512_castps_si512(v);
+  const __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  bits = _mm512_mask_or_epi32(bits, nan, bits, _mm512_set1_epi32(0x00400000));
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  bits = _mm512_add_epi32(bits,
+                          _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF)));
+  return _mm512_srli_epi32(bits, 16);
+}
+
+void ToBFloat16(const float* input, uint16_t* output, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m512i v = RoundToBFloat16(_mm512_loadu_ps(input + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                        _mm512_cvtepi32_epi16(v));
+  }
+  Scalar()->ToBFloat16(input + i, output + i, size - i);
+}
+
+void FromBFloat16(const uint16_t* input, float* output, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m512i v = _mm512_cvtepu16_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)));
+    _mm512_storeu_ps(output + i, _mm512_castsi512_ps(_mm512_slli_epi32(v, 16)));
+  }
+  Scalar()->FromBFloat16(input + i, output + i, size - i);
+}
+
+void ToFloat16(const float* input, uint16_t* output, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i v = _mm512_cvtps_ph(_mm512_loadu_ps(input + i),
+                                      _MM_FROUND_TO_NEAREST_INT);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), v);
+  }
+  Scalar()->ToFloat16(input + i, output + i, size - i);
+}
+
+void FromFloat16(const uint16_t* input, float* output, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+    _mm512_storeu_ps(output + i, _mm512_cvtph_ps(v));
+  }
+  Scalar()->FromFloat16(input + i, output + i, size - i);
+}
+
+}  // namespace
+
+const Table* AVX512() {
+  static const Table table = [] {
+    Table table = generic::Kernels<V>::MakeTable("AVX-512");
+    table.ToBFloat16 = ToBFloat16;
+    table.FromBFloat16 = FromBFloat16;
+    table.ToFloat16 = ToFloat16;
+    table.FromFloat16 = FromFloat16;
+    return table;
+  }();
+  return &table;
+}
+
+}  // namespace kernel
+
+#else
+
+const kernel::Table* kernel::AVX512() {
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef KERNEL_GENERIC_H
+#define KERNEL_GENERIC_H
+
+#include "kernel/Kernel.hpp"
+
+// The kernels, written once for any SIMD instruction set.
+//
+// |V| describes a vector register of V::width floats:
+//   using Type;                           // The register.
+//   Type Zero(), Set(float);
+//   Type Load(const float*);              // Unaligned.
+//   void Store(float*, Type);             // Unaligned.
+//   Type Add(Type, Type), Sub(Type, Type), Mul(Type, Type);
+//   Type MulAdd(Type a, Type b, Type c);  // a * b + c
+//   Type Min(Type, Type), Max(Type, Type);
+//   float ReduceAdd(Type), ReduceMin(Type), ReduceMax(Type);
+//
+// This must only be included by the file compiled for the instruction set of
+// |V|, with |V| defined in an anonymous namespace.
+//
+// Nothing used here may be an inline function shared with other files, like
+// std::min. Its copy compiled for this instruction set could be the one the
+// linker keeps for the whole program, and crash on older CPUs. The helpers
+// below have internal linkage instead.
+namespace kernel {
+namespace generic {
+namespace {
+
+template <class T>
+T Minimum(T a, T b) {
+  return b < a ? b : a;
+}
+
+template <class T>
+T Maximum(T a, T b) {
+  return a < b ? b : a;
+}
+
+}  // namespace
+
+template <class V>
+struct Kernels {
+  using Type = typename V::Type;
+  static constexpr size_t W = V::width;
+
+  static float SquareSum(const float* data, size_t size) {
+    // Two accumulators, to hide the latency of the additions.
+    Type sum_0 = V::Zero();
+    Type sum_1 = V::Zero();
+    size_t i = 0;
+    for (; i + 2 * W <= size; i += 2 * W) {
+      Type a = V::Load(data + i);
+      Type b = V::Load(data + i + W);
+      sum_0 = V::MulAdd(a, a, sum_0);
+      sum_1 = V::MulAdd(b, b, sum_1);
+    }
+    for (; i + W <= size; i += W) {
+      Type a = V::Load(data + i);
+      sum_0 = V::MulAdd(a, a, sum_0);
+    }
+    float ret = V::ReduceAdd(V::Add(sum_0, sum_1));
+    for (; i < size; ++i)
+      ret += data[i] * data[i];
+    return ret;
+  }
+
+  static void MinMax(const float* data, size_t size, float* min, float* max) {
+    size_t i = 0;
+    float v_min = data[0];
+    float v_max = data[0];
+    if (size >= W) {
+      Type r_min = V::Load(data);
+      Type r_max = r_min;
+      for (i = W; i + W <= size; i += W) {
+        Type v = V::Load(data + i);
+        r_min = V::Min(r_min, v);
+        r_max = V::Max(r_max, v);
+      }
+      v_min = V::ReduceMin(r_min);
+      v_max = V::ReduceMax(r_max);
+    }
+    for (; i < size; ++i) {
+      v_min = Minimum(v_min, data[i]);
+      v_max = Maximum(v_max, data[i]);
+    }
+    *min = v_min;
+    *max = v_max;
+  }
+
+  static size_t ArgMax(const float* data, size_t size) {
+    // Find the maximum with the vector unit, then its first position. The
+    // second pass stops as soon as it is found.
+    float min, max;
+    MinMax(data, size, &min, &max);
+    for (size_t i = 0; i < size; ++i) {
+      if (data[i] == max)
+        return i;
+    }
+    return 0;
+  }
+
+  static void Clip(float* data, size_t size, float min, float max) {
+    const Type r_min = V::Set(min);
+    const Type r_max = V::Set(max);
+    size_t i = 0;
+    for (; i + W <= size; i += W)
+      V::Store(data + i, V::Min(r_max, V::Max(r_min, V::Load(data + i))));
+    for (; i < size; ++i)
+      data[i] = Minimum(max, Maximum(min, data[i]));
+  }
+
+  static void Affine(float* data,
+                     size_t size,
+                     float offset,
+                     float scale,
+                     float shift) {
+    const Type r_offset = V::Set(offset);
+    const Type r_scale = V::Set(scale);
+    const Type r_shift = V::Set(shift);
+    size_t i = 0;
+    for (; i + W <= size; i += W) {
+      Type v = V::Sub(V::Load(data + i), r_offset);
+      V::Store(data + i, V::MulAdd(v, r_scale, r_shift));
+    }
+    for (; i < size; ++i)
+      data[i] = (data[i] - offset) * scale + shift;
+  }
+
+  static void Fill(float* data, size_t size, float value) {
+    const Type r_value = V::Set(value);
+    size_t i = 0;
+    for (; i + W <= size; i += W)
+      V::Store(data + i, r_value);
+    for (; i < size; ++i)
+      data[i] = value;
+  }
+
+  static void Add(float* data, const float* other, size_t size) {
+    size_t i = 0;
+    for (; i + W <= size; i += W)
+      V::Store(data + i, V::Add(V::Load(data + i), V::Load(other + i)));
+    for (; i < size; ++i)
+      data[i] += other[i];
+  }
+
+  static void Scale(float* data, size_t size, float lambda) {
+    const Type r_lambda = V::Set(lambda);
+    size_t i = 0;
+    for (; i + W <= size; i += W)
+      V::Store(data + i, V::Mul(V::Load(data + i), r_lambda));
+    for (; i < size; ++i)
+      data[i] *= lambda;
+  }
+
+  // MatMulTransposed() as tiled dot products. A tile of R x C dot products,
+  // R <= MR and C <= NR, keeps R * C vector accumulators, and loads each value
+  // of A and B once for the whole tile. Each accumulator is reduced to a float
+  // at the end of its slice. Nothing is packed: this is not a GEMM
+  // micro-kernel, and each value of A is only reused across C outputs. The dot
+  // products are cut in slices of KC values, so that the rows of B used by a
+  // block of NC outputs stay in cache while every row of A goes through them.
+  static constexpr size_t MR = 4;
+  static constexpr size_t NR = 2;
+  static constexpr size_t KC = 512;
+  static constexpr size_t NC = 32;
+
+  template <size_t R, size_t C>
+  static void Tile(size_t k,
+                   const float* A,
+                   size_t lda,
+                   const float* B,
+                   size_t ldb,
+                   float* out,
+                   size_t ldc) {
+    Type sum[R][C];
+    for (size_t r = 0; r < R; ++r) {
+      for (size_t c = 0; c < C; ++c)
+        sum[r][c] = V::Zero();
+    }
+
+    size_t p = 0;
+    for (; p + W <= k; p += W) {
+      Type b[C];
+      for (size_t c = 0; c < C; ++c)
+        b[c] = V::Load(B + c * ldb + p);
+      for (size_t r = 0; r < R; ++r) {
+        const Type a = V::Load(A + r * lda + p);
+        for (size_t c = 0; c < C; ++c)
+          sum[r][c] = V::MulAdd(a, b[c], sum[r][c]);
+      }
+    }
+
+    for (size_t r = 0; r < R; ++r) {
+      for (size_t c = 0; c < C; ++c) {
+        float v = V::ReduceAdd(sum[r][c]);
+        for (size_t q = p; q < k; ++q)
+          v += A[r * lda + q] * B[c * ldb + q];
+        out[r * ldc + c] += v;
+      }
+    }
+  }
+
+  using TileFunction = void (*)(size_t, const float*, size_t, const float*,
+                                size_t, float*, size_t);
+
+  static void MatMulTransposed(size_t m,
+                               size_t n,
+                               size_t k,
+                               const float* A,
+                               size_t lda,
+                               const float* B,
+                               size_t ldb,
+                               float* C,
+                               size_t ldc) {
+    // By number of rows and columns, for the tiles at the edges.
+    static constexpr TileFunction tiles[MR][NR] = {
+        {Tile<1, 1>, Tile<1, 2>},
+        {Tile<2, 1>, Tile<2, 2>},
+        {Tile<3, 1>, Tile<3, 2>},
+        {Tile<4, 1>, Tile<4, 2>},
+    };
+
+    for (size_t p = 0; p < k; p += KC) {
+      const size_t kc = Minimum(size_t(KC), k - p);
+      for (size_t j_block = 0; j_block < n; j_block += NC) {
+        const size_t j_end = Minimum(n, j_block + size_t(NC));
+        for (size_t i = 0; i < m; i += MR) {
+          const size_t rows = Minimum(size_t(MR), m - i);
+          for (size_t j = j_block; j < j_end; j += NR) {
+            const size_t columns = Minimum(size_t(NR), j_end - j);
+            tiles[rows - 1][columns - 1](kc, A + i * lda + p, lda,
+                                         B + j * ldb + p, ldb, C + i * ldc + j,
+                                         ldc);
+          }
+        }
+      }
+    }
+  }
+
+  // MatMul() as register tiled outer products. A tile covers R <= MR rows and
+  // C <= NR registers of columns of C, kept in registers while each value of A
+  // is broadcast over the matching row of B. A and B are read in place, not
+  // packed. B is cut in slices of KC rows and NB columns, that stay in cache
+  // while every row of A goes through them.
+  static constexpr size_t NB = 256;
+
+  template <size_t R, size_t C>
+  static void BroadcastTile(size_t k,
+                            const float* A,
+                            size_t lda_i,
+                            size_t lda_p,
+                            const float* B,
+                            size_t ldb,
+                            float* out,
+                            size_t ldc) {
+    Type sum[R][C];
+    for (size_t r = 0; r < R; ++r) {
+      for (size_t c = 0; c < C; ++c)
+        sum[r][c] = V::Load(out + r * ldc + c * W);
+    }
+
+    for (size_t p = 0; p < k; ++p) {
+      Type b[C];
+      for (size_t c = 0; c < C; ++c)
+        b[c] = V::Load(B + p * ldb + c * W);
+      for (size_t r = 0; r < R; ++r) {
+        const Type a = V::Set(A[r * lda_i + p * lda_p]);
+        for (size_t c = 0; c < C; ++c)
+          sum[r][c] = V::MulAdd(a, b[c], sum[r][c]);
+      }
+    }
+
+    for (size_t r = 0; r < R; ++r) {
+      for (size_t c = 0; c < C; ++c)
+        V::Store(out + r * ldc + c * W, sum[r][c]);
+    }
+  }
+
+  using BroadcastTileFunction = void (*)(size_t, const float*, size_t, size_t,
+                                         const float*, size_t, float*, size_t);
+
+  static void MatMul(size_t m,
+                     size_t n,
+                     size_t k,
+                     const float* A,
+                     size_t lda_i,
+                     size_t lda_p,
+                     const float* B,
+                     size_t ldb,
+                     float* C,
+                     size_t ldc) {
+    // By number of rows and registers, for the tiles at the edges.
+    static constexpr BroadcastTileFunction tiles[MR][NR] = {
+        {BroadcastTile<1, 1>, BroadcastTile<1, 2>},
+        {BroadcastTile<2, 1>, BroadcastTile<2, 2>},
+        {BroadcastTile<3, 1>, BroadcastTile<3, 2>},
+        {BroadcastTile<4, 1>, BroadcastTile<4, 2>},
+    };
+
+    // The last columns don't fill a register.
+    const size_t n_vector = n - n % W;
+
+    for (size_t p = 0; p < k; p += KC) {
+      const size_t kc = Minimum(size_t(KC), k - p);
+      for (size_t j_block = 0; j_block < n_vector; j_block += NB) {
+        const size_t j_end = Minimum(n_vector, j_block + size_t(NB));
+        for (size_t i = 0; i < m; i += MR) {
+          const size_t rows = Minimum(size_t(MR), m - i);
+          for (size_t j = j_block; j < j_end; j += NR * W) {
+            const size_t registers = Minimum(size_t(NR), (j_end - j) / W);
+            tiles[rows - 1][registers - 1](
+                kc, A + i * lda_i + p * lda_p, lda_i, lda_p, B + p * ldb + j,
+                ldb, C + i * ldc + j, ldc);
+          }
+        }
+      }
+
+      for (size_t i = 0; i < m; ++i) {
+        for (size_t j = n_vector; j < n; ++j) {
+          float sum = 0.f;
+          for (size_t q = p; q < p + kc; ++q)
+            sum += A[i * lda_i + q * lda_p] * B[q * ldb + j];
+          C[i * ldc + j] += sum;
+        }
+      }
+    }
+  }
+
+  // The conversions are specific to each instruction set. They default to the
+  // scalar ones.
+  static Table MakeTable(const char* name) {
+    const Table& scalar = *Scalar();
+    return {name,
+            SquareSum,
+            ArgMax,
+            MinMax,
+            Clip,
+            Affine,
+            Fill,
+            Add,
+            Scale,
+            MatMulTransposed,
+            MatMul,
+            scalar.ToBFloat16,
+            scalar.FromBFloat16,
+            scalar.ToFloat16,
+            scalar.FromFloat16};
+  }
+};
+
+}  // namespace generic
+}  // namespace kernel
+
+#endif /* end of include guard: KERNEL_GENERIC_H */
@@ -0,0 +1,40 @@
+#include "kernel/Kernel.hpp"
+
+namespace kernel {
+
+namespace {
+
+bool CPUSupports(const Table* table) {
+  if (!table)
+    return false;
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  if (table == SSE41())
+    return __builtin_cpu_supports("sse4.1");
+  if (table == AVX2())
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+           __builtin_cpu_supports("f16c");
+  if (table == AVX512())
+    return __builtin_cpu_supports("avx512f");
+#endif
+  return table == Scalar();
+}
+
+}  // namespace
+
+std::vector<const Table*> Supported() {
+  std::vector<const Table*> tables;
+  for (const Table* table : {Scalar(), SSE41(), AVX2(), AVX512()}) {
+    if (CPUSupports(table))
+      tables.push_back(table);
+  }
+  return tables;
+}
+
+const Table& Get() {
+  static const Table* table = Supported().back();
+  return *table;
+}
+
+}  // namespace kernel
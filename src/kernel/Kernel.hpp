@@ -0,0 +1,91 @@
+#ifndef KERNEL_KERNEL_H
+#define KERNEL_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::size_t;
+
+// Low level loops over float arrays, with one implementation per instruction
+// set. The best one supported by the CPU running the program is selected the
+// first time it is used, so a single binary runs everywhere at full speed.
+//
+// The arrays don't need to be aligned. Every implementation gives the same
+// results as the scalar one, except for the rounding of the sums.
+namespace kernel {
+
+struct Table {
+  const char* name;
+
+  // Sum of the squared values.
+  float (*SquareSum)(const float* data, size_t size);
+  // Index of the first maximum. |size| must be positive.
+  size_t (*ArgMax)(const float* data, size_t size);
+  // Bounds of the values. |size| must be positive.
+  void (*MinMax)(const float* data, size_t size, float* min, float* max);
+
+  // data[i] = min(max, max(min, data[i]))
+  void (*Clip)(float* data, size_t size, float min, float max);
+  // data[i] = (data[i] - offset) * scale + shift
+  void (*Affine)(float* data, size_t size, float offset, float scale,
+                 float shift);
+  // data[i] = value
+  void (*Fill)(float* data, size_t size, float value);
+  // data[i] += other[i]
+  void (*Add)(float* data, const float* other, size_t size);
+  // data[i] *= lambda
+  void (*Scale)(float* data, size_t size, float lambda);
+
+  // C[i * ldc + j] += sum_p A[i * lda + p] * B[j * ldb + p]
+  // for i < m, j < n and p < k. A holds one row per sample and B one row per
+  // output, like the params of a Linear. Computed as tiled dot products: each
+  // row of B is read once per block of rows of A, instead of once per row.
+  void (*MatMulTransposed)(size_t m,
+                           size_t n,
+                           size_t k,
+                           const float* A,
+                           size_t lda,
+                           const float* B,
+                           size_t ldb,
+                           float* C,
+                           size_t ldc);
+  // C[i * ldc + j] += sum_p A[i * lda_i + p * lda_p] * B[p * ldb + j]
+  // for i < m, j < n and p < k. Computed as outer products: the values of A
+  // are broadcast over rows of B, so A can be read transposed, with lda_i = 1.
+  void (*MatMul)(size_t m,
+                 size_t n,
+                 size_t k,
+                 const float* A,
+                 size_t lda_i,
+                 size_t lda_p,
+                 const float* B,
+                 size_t ldb,
+                 float* C,
+                 size_t ldc);
+
+  // Conversions to and from half-width floats, rounding to nearest even.
+  // bfloat16 is the upper half of a float: same range, 8 bits of mantissa.
+  // float16 is IEEE half precision: 11 bits of mantissa, up to 65504.
+  void (*ToBFloat16)(const float* input, uint16_t* output, size_t size);
+  void (*FromBFloat16)(const uint16_t* input, float* output, size_t size);
+  void (*ToFloat16)(const float* input, uint16_t* output, size_t size);
+  void (*FromFloat16)(const uint16_t* input, float* output, size_t size);
+};
+
+// The implementations. Return nullptr when the implementation hasn't been
+// compiled in, for instance when the target isn't x86.
+const Table* Scalar();
+const Table* SSE41();
+const Table* AVX2();
+const Table* AVX512();
+
+// Every implementation usable on this CPU, from the slowest to the fastest.
+std::vector<const Table*> Supported();
+
+// The fastest implementation usable on this CPU.
+const Table& Get();
+
+}  // namespace kernel
+
+#endif /* end of include guard: KERNEL_KERNEL_H */
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+#include "kernel/Kernel.hpp"
+
+namespace {
+
+std::vector<float> RandomValues(size_t size) {
+  static std::mt19937 rng;
+  std::normal_distribution<float> random(0.f, 1.f);
+  std::vector<float> values(size);
+  for (auto& v : values)
+    v = random(rng);
+  return values;
+}
+
+}  // namespace
+
+// Every implementation supported by this CPU must agree with the scalar one.
+TEST(Kernel, MatchesScalar) {
+  const kernel::Table& ref = *kernel::Scalar();
+  for (const kernel::Table* table : kernel::Supported()) {
+    SCOPED_TRACE(table->name);
+    const kernel::Table& k = *table;
+
+    // Odd sizes, to exercise the remainder loops.
+    for (size_t size : {1, 3, 17, 100, 1001}) {
+      SCOPED_TRACE(size);
+      const std::vector<float> input = RandomValues(size);
+      const std::vector<float> other = RandomValues(size);
+
+      EXPECT_NEAR(k.SquareSum(input.data(), size),
+                  ref.SquareSum(input.data(), size), 1e-3f * size);
+      EXPECT_EQ(k.ArgMax(input.data(), size), ref.ArgMax(input.data(), size));
+
+      float min, max, ref_min, ref_max;
+      k.MinMax(input.data(), size, &min, &max);
+      ref.MinMax(input.data(), size, &ref_min, &ref_max);
+      EXPECT_EQ(min, ref_min);
+      EXPECT_EQ(max, ref_max);
+
+      std::vector<float> a = input;
+      std::vector<float> b = input;
+      k.Clip(a.data(), size, -0.5f, 0.7f);
+      ref.Clip(b.data(), size, -0.5f, 0.7f);
+      EXPECT_EQ(a, b);
+
+      k.Add(a.data(), other.data(), size);
+      ref.Add(b.data(), other.data(), size);
+      EXPECT_EQ(a, b);
+
+      k.Scale(a.data(), size, 3.f);
+      ref.Scale(b.data(), size, 3.f);
+      EXPECT_EQ(a, b);
+
+      k.Affine(a.data(), size, 0.5f, 2.f, -1.f);
+      ref.Affine(b.data(), size, 0.5f, 2.f, -1.f);
+      for (size_t i = 0; i < size; ++i)
+        EXPECT_NEAR(a[i], b[i], 1e-5f);
+
+      k.Fill(a.data(), size, 2.f);
+      EXPECT_EQ(a, std::vector<float>(size, 2.f));
+    }
+  }
+}
+
+// Ties resolve to the first maximum.
+TEST(Kernel, ArgMaxFirst) {
+  std::vector<float> values(40, 1.f);
+  for (const kernel::Table* table : kernel::Supported()) {
+    SCOPED_TRACE(table->name);
+    EXPECT_EQ(table->ArgMax(values.data(), values.size()), 0u);
+  }
+}
+
+TEST(Kernel, HalfConversions) {
+  const std::vector<float> known = {1.f, -2.f, 65504.f, 1e5f, 1e-7f, 0.f};
+  const std::vector<uint16_t> bfloat16 = {0x3F80, 0xC000, 0x4780,
+                                          0x47C3, 0x33D7, 0x0000};
+  const std::vector<uint16_t> float16 = {0x3C00, 0xC000, 0x7BFF,
+                                         0x7C00, 0x0002, 0x0000};
+
+  for (const kernel::Table* table : kernel::Supported()) {
+    SCOPED_TRACE(table->name);
+    const kernel::Table& k = *table;
+    std::vector<uint16_t> half(known.size());
+
+    k.ToBFloat16(known.data(), half.data(), known.size());
+    EXPECT_EQ(half, bfloat16);
+    k.ToFloat16(known.data(), half.data(), known.size());
+    EXPECT_EQ(half, float16);
+
+    // Odd sizes, to exercise the remainder loops.
+    for (size_t size : {1, 17, 1001}) {
+      SCOPED_TRACE(size);
+      const std::vector<float> input = RandomValues(size);
+      std::vector<uint16_t> a(size), b(size);
+      std::vector<float> c(size), d(size);
+
+      k.ToBFloat16(input.data(), a.data(), size);
+      kernel::Scalar()->ToBFloat16(input.data(), b.data(), size);
+      EXPECT_EQ(a, b);
+      k.FromBFloat16(a.data(), c.data(), size);
+      kernel::Scalar()->FromBFloat16(b.data(), d.data(), size);
+      EXPECT_EQ(c, d);
+
+      k.ToFloat16(input.data(), a.data(), size);
+      kernel::Scalar()->ToFloat16(input.data(), b.data(), size);
+      EXPECT_EQ(a, b);
+      k.FromFloat16(a.data(), c.data(), size);
+      kernel::Scalar()->FromFloat16(b.data(), d.data(), size);
+      EXPECT_EQ(c, d);
+      for (size_t i = 0; i < size; ++i)
+        EXPECT_NEAR(c[i], input[i], std::abs(input[i]) / 1024.f + 1e-7f);
+    }
+  }
+}
+
+TEST(Kernel, MatMulTransposed) {
+  const kernel::Table& ref = *kernel::Scalar();
+  for (const kernel::Table* table : kernel::Supported()) {
+    SCOPED_TRACE(table->name);
+    // Sizes around the blocking, and rows longer than their values.
+    for (size_t m : {1, 5, 9})
+    for (size_t n : {1, 3, 33})
+    for (size_t k : {1, 7, 600}) {
+      SCOPED_TRACE(std::to_string(m) + "x" + std::to_string(n) + "x" +
+                   std::to_string(k));
+      const size_t lda = k + 1;
+      const size_t ldb = k + 2;
+      const size_t ldc = n + 1;
+      const std::vector<float> A = RandomValues(m * lda);
+      const std::vector<float> B = RandomValues(n * ldb);
+      std::vector<float> C = RandomValues(m * ldc);
+      std::vector<float> expected = C;
+
+      table->MatMulTransposed(m, n, k, A.data(), lda, B.data(), ldb, C.data(),
+                              ldc);
+      ref.MatMulTransposed(m, n, k, A.data(), lda, B.data(), ldb,
+                           expected.data(), ldc);
+      for (size_t i = 0; i < C.size(); ++i)
+        EXPECT_NEAR(C[i], expected[i], 1e-4f * k);
+    }
+  }
+}
+
+TEST(Kernel, MatMul) {
+  const kernel::Table& ref = *kernel::Scalar();
+  for (const kernel::Table* table : kernel::Supported()) {
+    SCOPED_TRACE(table->name);
+    for (size_t m : {1, 5, 9})
+    for (size_t n : {1, 7, 40, 300})
+    for (size_t k : {1, 8, 600})
+    for (bool transposed : {false, true}) {
+      SCOPED_TRACE(std::to_string(m) + "x" + std::to_string(n) + "x" +
+                   std::to_string(k) + (transposed ? " transposed" : ""));
+      // A is read either by rows or by columns, with some padding.
+      const size_t lda_i = transposed ? 1 : k + 1;
+      const size_t lda_p = transposed ? m + 1 : 1;
+      const size_t ldb = n + 2;
+      const size_t ldc = n + 1;
+      const std::vector<float> A = RandomValues((m + 1) * (k + 1));
+      const std::vector<float> B = RandomValues(k * ldb);
+      std::vector<float> C = RandomValues(m * ldc);
+      std::vector<float> expected = C;
+
+      table->MatMul(m, n, k, A.data(), lda_i, lda_p, B.data(), ldb, C.data(),
+                    ldc);
+      ref.MatMul(m, n, k, A.data(), lda_i, lda_p, B.data(), ldb,
+                 expected.data(), ldc);
+      for (size_t i = 0; i < C.size(); ++i)
+        EXPECT_NEAR(C[i], expected[i], 1e-4f * k);
+    }
+  }
+}
@@ -0,0 +1,91 @@
+#include "kernel/Kernel.hpp"
+
+#if defined(__SSE4_1__)
+
+#include <smmintrin.h>
+#include "kernel/Generic.hpp"
+
+namespace kernel {
+
+namespace {
+
+struct V {
+  using Type = __m128;
+  static constexpr size_t width = 4;
+
+  static Type Zero() { return _mm_setzero_ps(); }
+  static Type Set(float v) { return _mm_set1_ps(v); }
+  static Type Load(const float* p) { return _mm_loadu_ps(p); }
+  static void Store(float* p, Type v) { _mm_storeu_ps(p, v); }
+  static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+  static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+  static Type MulAdd(Type a, Type b, Type c) { return Add(Mul(a, b), c); }
+  static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+  static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+
+  // Combine the 4 lanes with |op|.
+  template <class Op>
+  static float Reduce(Type v, Op op) {
+    v = op(v, _mm_movehl_ps(v, v));
+    v = op(v, _mm_shuffle_ps(v, v, 0x55));
+    return _mm_cvtss_f32(v);
+  }
+  static float ReduceAdd(Type v) { return Reduce(v, Add); }
+  static float ReduceMin(Type v) { return Reduce(v, Min); }
+  static float ReduceMax(Type v) { return Reduce(v, Max); }
+};
+
+// Round the floats to their upper 16 bits, to nearest even. See Scalar.cpp.
+__m128i RoundToBFloat16(__m128 v) {
+  __m128i bits = _mm_castps_si128(v);
+  const __m128i nan = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+  bits = _mm_or_si128(bits, _mm_and_si128(nan, _mm_set1_epi32(0x00400000)));
+  const __m128i lsb =
+      _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+  bits = _mm_add_epi32(bits, _mm_add_epi32(lsb, _mm_set1_epi32(0x7FFF)));
+  return _mm_srli_epi32(bits, 16);
+}
+
+void ToBFloat16(const float* input, uint16_t* output, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i a = RoundToBFloat16(_mm_loadu_ps(input + i));
+    const __m128i b = RoundToBFloat16(_mm_loadu_ps(input + i + 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_packus_epi32(a, b));
+  }
+  Scalar()->ToBFloat16(input + i, output + i, size - i);
+}
+
+void FromBFloat16(const uint16_t* input, float* output, size_t size) {
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128i v = _mm_cvtepu16_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i)));
+    _mm_storeu_ps(output + i, _mm_castsi128_ps(_mm_slli_epi32(v, 16)));
+  }
+  Scalar()->FromBFloat16(input + i, output + i, size - i);
+}
+
+}  // namespace
+
+const Table* SSE41() {
+  static const Table table = [] {
+    Table table = generic::Kernels<V>::MakeTable("SSE4.1");
+    table.ToBFloat16 = ToBFloat16;
+    table.FromBFloat16 = FromBFloat16;
+    return table;
+  }();
+  return &table;
+}
+
+}  // namespace kernel
+
+#else
+
+const kernel::Table* kernel::SSE41() {
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstring>
+#include "kernel/Kernel.hpp"
+
+namespace kernel {
+
+namespace {
+
+float SquareSum(const float* data, size_t size) {
+  float ret = 0.f;
+  for (size_t i = 0; i < size; ++i)
+    ret += data[i] * data[i];
+  return ret;
+}
+
+size_t ArgMax(const float* data, size_t size) {
+  size_t i_max = 0;
+  for (size_t i = 1; i < size; ++i) {
+    if (data[i] > data[i_max])
+      i_max = i;
+  }
+  return i_max;
+}
+
+void MinMax(const float* data, size_t size, float* min, float* max) {
+  *min = data[0];
+  *max = data[0];
+  for (size_t i = 1; i < size; ++i) {
+    *min = std::min(*min, data[i]);
+    *max = std::max(*max, data[i]);
+  }
+}
+
+void Clip(float* data, size_t size, float min, float max) {
+  for (size_t i = 0; i < size; ++i)
+    data[i] = std::min(max, std::max(min, data[i]));
+}
+
+void Affine(float* data, size_t size, float offset, float scale, float shift) {
+  for (size_t i = 0; i < size; ++i)
+    data[i] = (data[i] - offset) * scale + shift;
+}
+
+void Fill(float* data, size_t size, float value) {
+  std::fill(data, data + size, value);
+}
+
+void Add(float* data, const float* other, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    data[i] += other[i];
+}
+
+void Scale(float* data, size_t size, float lambda) {
+  for (size_t i = 0; i < size; ++i)
+    data[i] *= lambda;
+}
+
+void MatMulTransposed(size_t m,
+                      size_t n,
+                      size_t k,
+                      const float* A,
+                      size_t lda,
+                      const float* B,
+                      size_t ldb,
+                      float* C,
+                      size_t ldc) {
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      float sum = 0.f;
+      for (size_t p = 0; p < k; ++p)
+        sum += A[i * lda + p] * B[j * ldb + p];
+      C[i * ldc + j] += sum;
+    }
+  }
+}
+
+void MatMul(size_t m,
+            size_t n,
+            size_t k,
+            const float* A,
+            size_t lda_i,
+            size_t lda_p,
+            const float* B,
+            size_t ldb,
+            float* C,
+            size_t ldc) {
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      float sum = 0.f;
+      for (size_t p = 0; p < k; ++p)
+        sum += A[i * lda_i + p * lda_p] * B[p * ldb + j];
+      C[i * ldc + j] += sum;
+    }
+  }
+}
+
+uint32_t Bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float Float(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void ToBFloat16(const float* input, uint16_t* output, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t bits = Bits(input[i]);
+    // Keep NaN a NaN: the rounding could otherwise carry it into infinity.
+    if (input[i] != input[i])
+      bits |= 0x00400000;
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    output[i] = bits >> 16;
+  }
+}
+
+void FromBFloat16(const uint16_t* input, float* output, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    output[i] = Float(uint32_t(input[i]) << 16);
+}
+
+uint16_t ToFloat16(float value) {
+  const uint32_t bits = Bits(value);
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs = bits & 0x7FFFFFFF;
+
+  // Infinity, and quiet NaN keeping the top of its payload.
+  if (abs >= 0x7F800000)
+    return sign | 0x7C00 | (abs > 0x7F800000 ? 0x0200 | (abs >> 13) : 0);
+
+  // Too big, rounds to infinity.
+  if (abs >= 0x477FF000)
+    return sign | 0x7C00;
+
+  // Subnormal or zero. Scaling by 2^-24 moves the half precision mantissa
+  // where the float addition rounds it.
+  if (abs < 0x38800000)
+    return sign | uint16_t(Bits(Float(abs) + 0.5f) - Bits(0.5f));
+
+  // Normal. Rebias the exponent, then round the 13 dropped bits.
+  const uint32_t rebiased = abs - 0x38000000;
+  return sign | uint16_t((rebiased + 0xFFF + ((rebiased >> 13) & 1)) >> 13);
+}
+
+float FromFloat16(uint16_t value) {
+  const uint32_t sign = uint32_t(value & 0x8000) << 16;
+  const uint32_t exponent = (value >> 10) & 0x1F;
+  const uint32_t mantissa = value & 0x3FF;
+
+  if (exponent == 0x1F)
+    return Float(sign | 0x7F800000 | (mantissa << 13));
+  if (exponent == 0) {
+    // Subnormal or zero: mantissa * 2^-24.
+    const float abs = float(mantissa) * Float(0x33800000);
+    return Float(sign | Bits(abs));
+  }
+  return Float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+void ToFloat16(const float* input, uint16_t* output, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    output[i] = ToFloat16(input[i]);
+}
+
+void FromFloat16(const uint16_t* input, float* output, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    output[i] = FromFloat16(input[i]);
+}
+
+const Table table = {
+    "Scalar", SquareSum,  ArgMax,       MinMax,    Clip,
+    Affine,   Fill,       Add,          Scale,     MatMulTransposed,
+    MatMul,   ToBFloat16, FromBFloat16, ToFloat16, FromFloat16,
+};
+
+}  // namespace
+
+const Table* Scalar() {
+  return &table;
+}
+
+}  // namespace kernel
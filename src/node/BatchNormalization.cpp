@@ -1,34 +1,46 @@
 #include "node/BatchNormalization.hpp"
+#include <algorithm>
 #include <cmath>
 
+namespace {
+
+// Weight of the past batches in the running statistics.
+constexpr float past_weight = 0.9f;
+
+float Scale(float mean, float square_mean) {
+  return 1.0 / std::sqrt(std::abs(square_mean - mean * mean) + 1e-4);
+}
+
+}  // namespace
+
 BatchNormalization::BatchNormalization(Node* node) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
 }
 
 void BatchNormalization::Forward(size_t batch_size) {
   size_t size = output[0].values.size();
 
-  float X = 0.f;
-  float XX = 0.f;
-  for (size_t batch = 0; batch < batch_size; ++batch) {
-    auto& I = input[batch]->values;
-    for (size_t i = 0; i < size; ++i) {
-      float x = I[i];
-      X += x;
-      XX += x * x;
+  if (frozen) {
+    inv_dev = RunningScale();
+  } else {
+    float X = 0.f;
+    float XX = 0.f;
+    for (size_t batch = 0; batch < batch_size; ++batch) {
+      auto& I = input[batch]->values;
+      for (size_t i = 0; i < size; ++i) {
+        float x = I[i];
+        X += x;
+        XX += x * x;
+      }
     }
-  }
 
-  float total = size * batch_size;
-  X /= total;
-  XX /= total;
-
-  //float mean = X;
-  inv_dev = 1.0 / std::sqrt(std::abs(XX - X * X) + 1e-4);
+    float total = size * batch_size;
+    mean = X / total;
+    square_mean = XX / total;
+    inv_dev = Scale(mean, square_mean);
+  }
 
   for (size_t batch = 0; batch < batch_size; ++batch) {
     auto& I = input[batch]->values;
@@ -42,6 +54,15 @@ void BatchNormalization::Forward(size_t batch_size) {
 }
 
 void BatchNormalization::Backward(size_t batch_size) {
+  // Only the batches trained on count in the running statistics, not the
+  // predictions.
+  if (!frozen) {
+    const float weight = std::min(past_weight, 1.f - 1.f / ++batches);
+    running_mean = weight * running_mean + (1.f - weight) * mean;
+    running_square_mean =
+        weight * running_square_mean + (1.f - weight) * square_mean;
+  }
+
   const size_t size = output[0].values.size();
   for (size_t batch = 0; batch < batch_size; ++batch) {
     auto& IS = input_sensitivity[batch].values;
@@ -51,3 +72,7 @@ void BatchNormalization::Backward(size_t batch_size) {
     }
   }
 }
+
+float BatchNormalization::RunningScale() const {
+  return Scale(running_mean, running_square_mean);
+}
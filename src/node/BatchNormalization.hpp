@@ -3,14 +3,39 @@
 
 #include "node/Node.hpp"
 
+// Divide the input by its standard deviation over the whole batch.
+//
+// The statistics of every batch trained on are also averaged into running
+// ones. Once frozen, the node uses them instead: a prediction doesn't depend
+// on the other samples of its batch anymore. See
+// pass::FoldBatchNormalization() to remove the node from an inference graph.
 class BatchNormalization : public Node {
  public:
   BatchNormalization(Node* input);
   ~BatchNormalization() = default;
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool BackwardNeedsOutput() const override { return false; }
+
+  // Use the running statistics instead of the ones of the batch.
+  void Freeze() { frozen = true; }
+  void Unfreeze() { frozen = false; }
+  bool IsFrozen() const { return frozen; }
+
+  // The factor applied to the input, from the running statistics.
+  float RunningScale() const;
+
  private:
   float inv_dev = 1.f;
+
+  // E[x] and E[x^2] of the last batch, and their running averages.
+  float mean = 0.f;
+  float square_mean = 1.f;
+  float running_mean = 0.f;
+  float running_square_mean = 1.f;
+  size_t batches = 0;
+  bool frozen = false;
 };
 
 #endif /* end of include guard: BATCH_NORMALIZATION_H */
@@ -1,11 +1,11 @@
 #include "node/Bias.hpp"
+#include "Thread.hpp"
 
 Bias::Bias(Node* node) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
+  output = Batch(capacity_, input[0]->sizes);
   params = Tensor::Random(input[0]->sizes);
-  InitInternalSensitivity();
 }
 
 void Bias::Forward(size_t batch_size) {
@@ -27,7 +27,7 @@ void Bias::Backward(size_t batch_size) {
   for (size_t batch = 0; batch < batch_size; ++batch) {
     Tensor& IS = input_sensitivity[batch];
     Tensor& OS = *(output_sensitivity[batch]);
-    Tensor& PS = params_sensitivity[batch];
+    Tensor& PS = params_sensitivity[Thread::Index()];
     for (size_t index = 0; index < size; ++index) {
       IS[index] = OS[index];
       PS[index] += OS[index];
@@ -8,6 +8,9 @@ class Bias : public Node {
   Bias(Node* input);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool BackwardNeedsOutput() const override { return false; }
+  bool CanRunInPlace() const override { return true; }
 };
 
 #endif /* end of include guard: BIAS_H */
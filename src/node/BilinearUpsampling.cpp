@@ -3,15 +3,13 @@
 BilinearUpsampling::BilinearUpsampling(Node* node) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor({
-                                      input[0]->sizes[0] * 2 + 2,  //
-                                      input[0]->sizes[1] * 2 + 2,  //
-                                      input[0]->sizes[2]           //
-                                  }));
+  output = Batch(capacity_, {
+                        input[0]->sizes[0] * 2 + 2,  //
+                        input[0]->sizes[1] * 2 + 2,  //
+                        input[0]->sizes[2]           //
+                    });
 
   params = Tensor();
-
-  InitInternalSensitivity();
 }
 
 void BilinearUpsampling::Forward(size_t batch_size) {
@@ -4,12 +4,10 @@ Border::Border(Node* node, size_t border_size, float value)
     : border_size(border_size), value(value) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
+  output = Batch(capacity_, input[0]->sizes);
 
   dim_x = input[0]->sizes[0];
   dim_y = input[0]->sizes[1];
-
-  InitInternalSensitivity();
 }
 
 void Border::Forward(size_t batch_size) {
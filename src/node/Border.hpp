@@ -8,6 +8,9 @@ class Border : public Node {
   Border(Node* input, size_t border_size, float value);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool BackwardNeedsOutput() const override { return false; }
+  bool CanRunInPlace() const override { return true; }
  private:
   size_t border_size;
   float value;
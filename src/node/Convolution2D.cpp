@@ -1,6 +1,8 @@
 #include <iostream>
 #include "node/Convolution2D.hpp"
 #include <cmath>
+#include "Thread.hpp"
+#include "Tracer.hpp"
 
 Convolution2D::Convolution2D(Node* node,
                              const std::vector<size_t> sizes,
@@ -38,17 +40,16 @@ Convolution2D::Convolution2D(Node* node,
   };
   // clang-format on
 
-  output = std::vector<Tensor>(T, Tensor(size_output));
+  output = Batch(capacity_, size_output);
   params = Tensor::Random(size_params);
   params *= 1.0f / sqrt(sizes[0] * sizes[1] * size_input[2]);
-
-  InitInternalSensitivity();
 }
 
 void Convolution2D::Forward(size_t batch_size) {
   // clang-format off
   #pragma omp parallel for
   for(size_t batch = 0; batch<batch_size; ++batch) {
+    Tracer::Span span("Convolution2D::Forward sample", "omp");
     Tensor& I = *(input[batch]);
     Tensor& O = output[batch];
     for(size_t f = 0; f<size_output[2]; ++f)
@@ -69,19 +70,33 @@ void Convolution2D::Forward(size_t batch_size) {
       }
       O.at(x,y,f) = v;
     }
+    if (!epilogue.empty())
+      epilogue.Forward(O);
   }
   // clang-format on
 }
 
+size_t Convolution2D::Flops() const {
+  return 2 * Multiply(size_output) * size_params[0] * size_params[1] *
+         size_params[2];
+}
+
+bool Convolution2D::BackwardNeedsOutput() const {
+  return epilogue.activation != Epilogue::Activation::None;
+}
+
 void Convolution2D::Backward(size_t batch_size) {
   // clang-format off
   #pragma omp parallel for
   for(size_t batch = 0; batch<batch_size; ++batch) {
+    Tracer::Span span("Convolution2D::Backward sample", "omp");
     Tensor& OS = *(output_sensitivity[batch]);
     Tensor& IS = input_sensitivity[batch];
     Tensor& I = *(input[batch]);
     Tensor& P = params;
-    Tensor& PS = params_sensitivity[batch];
+    if (!epilogue.empty())
+      epilogue.Backward(batch, output[batch], OS);
+    Tensor& PS = params_sensitivity[Thread::Index()];
 
     IS.Fill(0.f);
     for(size_t f = 0; f<size_output[2]; ++f)
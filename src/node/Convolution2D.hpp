@@ -2,6 +2,7 @@
 #define CONVOLUTION2D_H
 
 #include "Node.hpp"
+#include "node/Epilogue.hpp"
 
 class Convolution2D : public Node {
   public:
@@ -11,10 +12,15 @@ class Convolution2D : public Node {
                  size_t stride = 1);
    void Forward(size_t batch_size) override;
    void Backward(size_t batch_size) override;
+   bool BackwardNeedsOutput() const override;
+   size_t Flops() const override;
+
+   // The nodes fused into this one. See pass/Fusion.hpp.
+   Epilogue epilogue;
   private:
-    std::vector<size_t> size_input;
-    std::vector<size_t> size_params;
-    std::vector<size_t> size_output;
+    Shape size_input;
+    Shape size_params;
+    Shape size_output;
     const size_t stride;
 };
 
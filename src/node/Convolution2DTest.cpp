@@ -2,6 +2,8 @@
 #include "node/Input.hpp"
 #include "node/Convolution2D.hpp"
 #include "Model.hpp"
+#include "Random.hpp"
+#include "TensorExpression.hpp"
 #include "gtest/gtest.h"
 #include "Image.hpp"
 
@@ -36,6 +38,9 @@ Tensor multi_derivatives(Tensor& input) {
 }  // namespace
 
 TEST(Convolution2D, Convolution2D) {
+  // Whether the training converges depends on the random values.
+  Random::SeedGlobal(3);
+
   // Generate examples.
   std::vector<Example> examples;
   for (int i = 0; i < 1000; ++i) {
@@ -1,6 +1,8 @@
 #include "node/Deconvolution2D.hpp"
 #include <cmath>
 #include <iostream>
+#include "Thread.hpp"
+#include "Tracer.hpp"
 
 Deconvolution2D::Deconvolution2D(Node* node,
                              const std::vector<size_t> sizes,
@@ -30,17 +32,21 @@ Deconvolution2D::Deconvolution2D(Node* node,
   };
   // clang-format on
 
-  output = std::vector<Tensor>(T, Tensor(size_output));
+  output = Batch(capacity_, size_output);
   params = Tensor::Random(size_params);
   params *= 1.0f / sqrt(sizes[0] * sizes[1] * size_input[2]);
+}
 
-  InitInternalSensitivity();
+size_t Deconvolution2D::Flops() const {
+  return 2 * Multiply(size_input) * size_params[0] * size_params[1] *
+         size_params[3];
 }
 
 void Deconvolution2D::Forward(size_t batch_size) {
   // clang-format off
   #pragma omp parallel for
   for(size_t batch = 0; batch<batch_size; ++batch) {
+    Tracer::Span span("Deconvolution2D::Forward sample", "omp");
     Tensor& I = *(input[batch]);
     Tensor& O = output[batch];
     O.Fill(0.f);
@@ -71,9 +77,10 @@ void Deconvolution2D::Backward(size_t batch_size) {
   // clang-format off
   #pragma omp parallel for
   for(size_t batch = 0; batch < batch_size; ++batch) {
+    Tracer::Span span("Deconvolution2D::Backward sample", "omp");
     Tensor& I = *(input[batch]);
     Tensor& IS = input_sensitivity[batch];
-    Tensor& PS = params_sensitivity[batch];
+    Tensor& PS = params_sensitivity[Thread::Index()];
     Tensor& OS = *(output_sensitivity[batch]);
     IS.Fill(0.f);
     for(size_t z = 0; z<size_input[2]; ++z)
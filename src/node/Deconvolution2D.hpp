@@ -11,11 +11,13 @@ class Deconvolution2D : public Node {
                   size_t stride);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsOutput() const override { return false; }
+  size_t Flops() const override;
 
  private:
-  std::vector<size_t> size_input;
-  std::vector<size_t> size_params;
-  std::vector<size_t> size_output;
+  Shape size_input;
+  Shape size_params;
+  Shape size_output;
   const size_t stride;
 };
 
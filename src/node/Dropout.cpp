@@ -4,20 +4,20 @@ Dropout::Dropout(Node* node, float ratio) : ratio(ratio) {
   Link(node);
 
   params = Tensor();
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-  random = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
+  random = Batch(capacity_, input[0]->sizes);
 }
 
 void Dropout::Forward(size_t batch_size) {
+  const uint64_t current_step = step++;
   #pragma omp parallel for
   for(size_t batch = 0; batch < batch_size; ++batch) {
     Tensor& I = *(input[batch]);
     Tensor& O = output[batch];
     Tensor& R = random[batch];
 
-    R.UniformRandom();
+    Random(key, current_step, batch)
+        .Uniform(R.values.data(), R.values.size());
     const size_t size = I.values.size();
     for (size_t index = 0; index < size; ++index) {
       if (R[index] <= ratio) {
@@ -29,6 +29,12 @@ void Dropout::Forward(size_t batch_size) {
   }
 }
 
+void Dropout::SetCapacity(size_t capacity) {
+  Node::SetCapacity(capacity);
+  if (random.size() != capacity)
+    random = Batch(capacity, random[0].sizes);
+}
+
 void Dropout::Backward(size_t batch_size) {
   #pragma omp parallel for
   for(size_t batch = 0; batch < batch_size; ++batch) {
@@ -1,6 +1,7 @@
 #ifndef DROPOUT_H
 #define DROPOUT_H
 
+#include "Random.hpp"
 #include "node/Node.hpp"
 
 class Dropout : public Node {
@@ -8,9 +9,16 @@ class Dropout : public Node {
   Dropout(Node* input, float ratio);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  void SetCapacity(size_t capacity) override;
+  bool CanRecompute() const override { return false; }
  private:
   float ratio;
-  std::vector<Tensor> random;
+  Batch random;
+
+  // Sample |batch| of the |step|-th forward pass draws from the substream
+  // (step, batch) of this key.
+  uint64_t key = Random::NewKey();
+  uint64_t step = 0;
 };
 
 #endif /* end of include guard: DROPOUT_H */
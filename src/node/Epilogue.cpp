@@ -0,0 +1,79 @@
+#include "node/Epilogue.hpp"
+#include <cmath>
+#include "Thread.hpp"
+
+// The computations are the ones of the Bias, Relu, LeakyRelu, Sigmoid and Tanh
+// nodes, so that fusing them doesn't change the results.
+
+void Epilogue::Forward(Tensor& output) const {
+  const size_t size = output.values.size();
+  float* O = output.values.data();
+
+  if (bias) {
+    const float* B = bias->params.values.data();
+    for (size_t i = 0; i < size; ++i)
+      O[i] += B[i];
+  }
+
+  switch (activation) {
+    case Activation::None:
+      break;
+    case Activation::Relu:
+      for (size_t i = 0; i < size; ++i)
+        O[i] = O[i] > 0.f ? O[i] : 0.f;
+      break;
+    case Activation::LeakyRelu:
+      for (size_t i = 0; i < size; ++i)
+        O[i] = O[i] > 0.f ? O[i] : 0.1f * O[i];
+      break;
+    case Activation::Sigmoid:
+      for (size_t i = 0; i < size; ++i)
+        O[i] = 1.0 / (1.0 + exp(-O[i]));
+      break;
+    case Activation::Tanh:
+      for (size_t i = 0; i < size; ++i) {
+        const float e = exp(-2.0 * O[i]);
+        O[i] = (1.f - e) / (1.f + e);
+      }
+      break;
+  }
+}
+
+void Epilogue::Backward(size_t batch,
+                        const Tensor& output,
+                        Tensor& sensitivity) const {
+  const size_t size = output.values.size();
+  const float* O = output.values.data();
+  const float* OS = last->output_sensitivity[batch]->values.data();
+  float* S = sensitivity.values.data();
+
+  // The derivative of every activation is known from its output.
+  switch (activation) {
+    case Activation::None:
+      for (size_t i = 0; i < size; ++i)
+        S[i] = OS[i];
+      break;
+    case Activation::Relu:
+      for (size_t i = 0; i < size; ++i)
+        S[i] = O[i] > 0.f ? OS[i] : 0.f;
+      break;
+    case Activation::LeakyRelu:
+      for (size_t i = 0; i < size; ++i)
+        S[i] = O[i] > 0.f ? OS[i] : 0.1f * OS[i];
+      break;
+    case Activation::Sigmoid:
+      for (size_t i = 0; i < size; ++i)
+        S[i] = O[i] * (1.f - O[i]) * OS[i];
+      break;
+    case Activation::Tanh:
+      for (size_t i = 0; i < size; ++i)
+        S[i] = (1.f - O[i] * O[i]) * OS[i];
+      break;
+  }
+
+  if (bias) {
+    float* PS = bias->params_sensitivity[Thread::Index()].values.data();
+    for (size_t i = 0; i < size; ++i)
+      PS[i] += S[i];
+  }
+}
@@ -0,0 +1,34 @@
+#ifndef EPILOGUE_H
+#define EPILOGUE_H
+
+#include "node/Node.hpp"
+
+// Elementwise nodes applied by a Linear or a Convolution2D to each sample of
+// its output, right after computing it, instead of running on their own. See
+// pass/Fusion.hpp.
+//
+// An epilogue is an optional Bias followed by an optional activation. The
+// fused nodes stay in the graph for their params, but they don't run: their
+// output is an alias of the output of the node they are fused into.
+class Epilogue {
+ public:
+  enum class Activation { None, Relu, LeakyRelu, Sigmoid, Tanh };
+
+  bool empty() const { return !last; }
+
+  // Apply the bias and the activation to |output|, in place.
+  void Forward(Tensor& output) const;
+
+  // Sample |batch| of the backward pass. From the sensitivity of the last
+  // fused node and the final |output|, compute the sensitivity of the output
+  // before the epilogue into |sensitivity|. The gradient of the bias is
+  // accumulated too.
+  void Backward(size_t batch, const Tensor& output, Tensor& sensitivity) const;
+
+  Node* bias = nullptr;
+  Activation activation = Activation::None;
+  // The last fused node.
+  Node* last = nullptr;
+};
+
+#endif /* end of include guard: EPILOGUE_H */
@@ -1,10 +1,8 @@
 #include "Input.hpp"
 
-Input::Input(const std::vector<size_t>& size) {
-  output = std::vector<Tensor>(T, Tensor(size));
-  
-  params_sensitivity = std::vector<Tensor>(T, Tensor());
-  input_sensitivity = std::vector<Tensor>(T, Tensor());
+Input::Input(const Shape& size, size_t capacity) {
+  capacity_ = capacity;
+  output = Batch(capacity_, size);
 }
 
 void Input::Forward(size_t batch_size) {
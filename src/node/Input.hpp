@@ -5,7 +5,8 @@
 
 class Input : public Node {
  public:
-  Input(const std::vector<size_t>& size);
+  // |capacity| is the number of samples of a batch, for the whole graph.
+  Input(const Shape& size, size_t capacity = T);
 
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
@@ -1,65 +1,294 @@
 #include <iostream>
 #include "node/Linear.hpp"
+#include <algorithm>
 #include <cmath>
+#include "Thread.hpp"
+#include "Tracer.hpp"
+#include "kernel/Kernel.hpp"
 
-Linear::Linear(Node* node, std::vector<size_t> output_sizes) {
+Linear::Linear(Node* node, const Shape& output_sizes) {
   Link(node);
 
   input_size = input[0]->values.size();
   output_size = Multiply(output_sizes);
 
   params = Tensor({input_size + 1, output_size});
-  output = std::vector<Tensor>(T, Tensor(output_sizes));
+  output = Batch(capacity_, output_sizes);
 
   params.Randomize();
   params *= 1.f / sqrt(input_size);
+}
+
+namespace {
+
+// Number of outputs, or inputs, computed by a thread at once.
+constexpr size_t block_size = 32;
+
+// The first of |batch_size| samples when they follow each other in memory, or
+// nullptr. The samples of a Batch are contiguous. They are only split when they
+// come from somewhere else.
+float* Contiguous(const std::vector<Tensor*>& samples, size_t batch_size) {
+  float* data = samples[0]->values.data();
+  const size_t size = samples[0]->values.size();
+  for (size_t batch = 1; batch < batch_size; ++batch) {
+    if (samples[batch]->values.data() != data + batch * size)
+      return nullptr;
+  }
+  return data;
+}
+
+// out[r] += sum_n values[n] * W[r * stride + indices[n]] for r < rows <= 4.
+// The rows are read together, at increasing indices, and their sums don't
+// wait for each other.
+void SparseDot(size_t rows,
+               const float* W,
+               size_t stride,
+               const std::vector<size_t>& indices,
+               const std::vector<float>& values,
+               float* out) {
+  const size_t nonzero = indices.size();
+  if (rows < 4) {
+    for (size_t r = 0; r < rows; ++r) {
+      const float* w = W + r * stride;
+      float v = 0.f;
+      for (size_t n = 0; n < nonzero; ++n)
+        v += values[n] * w[indices[n]];
+      out[r] += v;
+    }
+    return;
+  }
+
+  float v0 = 0.f, v1 = 0.f, v2 = 0.f, v3 = 0.f;
+  for (size_t n = 0; n < nonzero; ++n) {
+    const float* w = W + indices[n];
+    v0 += values[n] * w[0];
+    v1 += values[n] * w[stride];
+    v2 += values[n] * w[2 * stride];
+    v3 += values[n] * w[3 * stride];
+  }
+  out[0] += v0;
+  out[1] += v1;
+  out[2] += v2;
+  out[3] += v3;
+}
+
+// G[r * stride + indices[n]] += in[r] * values[n] for r < rows <= 4.
+void SparseOuter(size_t rows,
+                 const float* in,
+                 const std::vector<size_t>& indices,
+                 const std::vector<float>& values,
+                 float* G,
+                 size_t stride) {
+  const size_t nonzero = indices.size();
+  if (rows < 4) {
+    for (size_t r = 0; r < rows; ++r) {
+      float* g = G + r * stride;
+      for (size_t n = 0; n < nonzero; ++n)
+        g[indices[n]] += in[r] * values[n];
+    }
+    return;
+  }
+
+  const float in0 = in[0], in1 = in[1], in2 = in[2], in3 = in[3];
+  for (size_t n = 0; n < nonzero; ++n) {
+    float* g = G + indices[n];
+    g[0] += in0 * values[n];
+    g[stride] += in1 * values[n];
+    g[2 * stride] += in2 * values[n];
+    g[3 * stride] += in3 * values[n];
+  }
+}
+
+}  // namespace
+
+size_t Linear::FindSparseInputs(size_t batch_size) {
+  if (sparse_inputs.size() < batch_size)
+    sparse_inputs.resize(batch_size);
 
-  InitInternalSensitivity();
+  const size_t limit = size_t(sparse_density * input_size);
+  size_t sparse = 0;
+  #pragma omp parallel for reduction(+ : sparse)
+  for (size_t batch = 0; batch < batch_size; ++batch) {
+    SparseInput& s = sparse_inputs[batch];
+    s.indices.clear();
+    s.values.clear();
+    s.sparse = false;
+    if (sparse_density <= 0.f)
+      continue;
+
+    // Stop as soon as there are too many nonzero values.
+    const float* I = input[batch]->values.data();
+    size_t i = 0;
+    for (; i < input_size; ++i) {
+      if (I[i] == 0.f)
+        continue;
+      if (s.indices.size() == limit)
+        break;
+      s.indices.push_back(i);
+      s.values.push_back(I[i]);
+    }
+    s.sparse = i == input_size;
+    sparse += s.sparse;
+  }
+  return sparse;
 }
 
 void Linear::Forward(size_t batch_size) {
+  // O = I * W^T + bias, as a single matrix product over the whole batch. Each
+  // row of the params holds the weights of one output, followed by its bias.
+  const size_t stride = input_size + 1;
+  float* O = output.data();
+
+  // A few sparse samples don't pay for leaving the batched product.
+  const float* I = Contiguous(input, batch_size);
+  const bool batched = I && 2 * FindSparseInputs(batch_size) <= batch_size;
+
+  // The outputs are split among the threads, so each one only reads its own
+  // rows of the params.
   #pragma omp parallel for
-  for(size_t batch = 0; batch < batch_size; ++batch) {
-    Tensor& O = output[batch];
-    Tensor& I = *(input[batch]);
-    size_t p = 0;
-    for (size_t output_index = 0; output_index < output_size; ++output_index) {
-      float v = 0.f;
+  for (size_t begin = 0; begin < output_size; begin += block_size) {
+    Tracer::Span span("Linear::Forward block", "omp");
+    const size_t count = std::min(block_size, output_size - begin);
+    const float* W = &params[begin * stride];
+    for (size_t batch = 0; batch < batch_size; ++batch) {
+      for (size_t i = 0; i < count; ++i)
+        O[batch * output_size + begin + i] = W[i * stride + input_size];
+    }
 
-      // Linear part.
-      for (size_t input_index = 0; input_index < input_size; ++input_index) {
-        v += I[input_index] * params[p++];
-      }
+    if (batched) {
+      kernel::Get().MatMulTransposed(batch_size, count, input_size, I,
+                                     input_size, W, stride, O + begin,
+                                     output_size);
+      continue;
+    }
 
-      // Bias pars.
-      v += params[p++];
+    for (size_t batch = 0; batch < batch_size; ++batch) {
+      if (!sparse_inputs[batch].sparse) {
+        kernel::Get().MatMulTransposed(
+            1, count, input_size, input[batch]->values.data(), input_size, W,
+            stride, O + batch * output_size + begin, output_size);
+      }
+    }
 
-      O[output_index] = v;
+    // The sparse samples go through a few rows of the params at a time, so
+    // that they stay in cache from one sample to the next.
+    for (size_t i = 0; i < count; i += 4) {
+      const size_t rows = std::min(size_t(4), count - i);
+      for (size_t batch = 0; batch < batch_size; ++batch) {
+        const SparseInput& s = sparse_inputs[batch];
+        if (s.sparse) {
+          SparseDot(rows, W + i * stride, stride, s.indices, s.values,
+                    O + batch * output_size + begin + i);
+        }
+      }
     }
   }
+
+  if (!epilogue.empty()) {
+    #pragma omp parallel for
+    for (size_t batch = 0; batch < batch_size; ++batch)
+      epilogue.Forward(output[batch]);
+  }
+}
+
+void Linear::ForwardDelta(size_t batch,
+                          const std::vector<size_t>& indices,
+                          const std::vector<float>& deltas,
+                          std::vector<float>& output_deltas) {
+  Tensor& O = output[batch];
+  const size_t changes = indices.size();
+  output_deltas.resize(output_size);
+  for (size_t output_index = 0; output_index < output_size; ++output_index) {
+    const float* p = &params[output_index * (input_size + 1)];
+    float delta = 0.f;
+    for (size_t change = 0; change < changes; ++change)
+      delta += deltas[change] * p[indices[change]];
+    O[output_index] += delta;
+    output_deltas[output_index] = delta;
+  }
+}
+
+bool Linear::BackwardNeedsOutput() const {
+  return epilogue.activation != Epilogue::Activation::None;
 }
 
 void Linear::Backward(size_t batch_size) {
+  if (!epilogue.empty()) {
+    #pragma omp parallel for
+    for (size_t batch = 0; batch < batch_size; ++batch)
+      epilogue.Backward(batch, output[batch], *output_sensitivity[batch]);
+  }
+
+  // Two matrix products over the whole batch:
+  //   dW = OS^T * I, and the bias gets the sum of OS over the batch.
+  //   IS = OS * W
+  // Each thread writes its own block of rows of dW, then of columns of IS, so
+  // the gradient needs a single slot, see GradientSlots().
+  const size_t stride = input_size + 1;
+  const float* OS = Contiguous(output_sensitivity, batch_size);
+  const float* I = Contiguous(input, batch_size);
+  // Looked for again: the inputs may have been recomputed since Forward().
+  const bool batched =
+      OS && I && 2 * FindSparseInputs(batch_size) <= batch_size;
+  float* PS = params_sensitivity[0].values.data();
+  float* IS = input_sensitivity.data();
+
   #pragma omp parallel for
-  for(size_t batch = 0; batch < batch_size; ++batch) {
-    Tensor& PS = params_sensitivity[batch];
-    Tensor& IS = input_sensitivity[batch];
-    Tensor& I = *(input[batch]);
-    Tensor& OS = *(output_sensitivity[batch]);
-
-    IS.Fill(0.f);
-    size_t p = 0;
-    for (size_t output_index = 0; output_index < output_size; ++output_index) {
-      const float os = OS[output_index];
-
-      // Linear part.
-      for (size_t input_index = 0; input_index < input_size; ++input_index) {
-        PS[p] += I[input_index] * os;
-        IS[input_index] += params[p++] * os;
+  for (size_t begin = 0; begin < output_size; begin += block_size) {
+    Tracer::Span span("Linear::Backward weights", "omp");
+    const size_t count = std::min(block_size, output_size - begin);
+    float* G = PS + begin * stride;
+    for (size_t batch = 0; batch < batch_size; ++batch) {
+      const float* os = output_sensitivity[batch]->values.data() + begin;
+      for (size_t i = 0; i < count; ++i)
+        G[i * stride + input_size] += os[i];
+    }
+
+    if (batched) {
+      kernel::Get().MatMul(count, input_size, batch_size, OS + begin, 1,
+                           output_size, I, input_size, G, stride);
+      continue;
+    }
+
+    for (size_t batch = 0; batch < batch_size; ++batch) {
+      if (!sparse_inputs[batch].sparse) {
+        kernel::Get().MatMul(
+            count, input_size, 1,
+            output_sensitivity[batch]->values.data() + begin, 1, output_size,
+            input[batch]->values.data(), input_size, G, stride);
       }
+    }
 
-      // Bias pars.
-      PS[p++] += os;
+    // Only the columns of the nonzero inputs of the sparse samples change.
+    for (size_t i = 0; i < count; i += 4) {
+      const size_t rows = std::min(size_t(4), count - i);
+      for (size_t batch = 0; batch < batch_size; ++batch) {
+        const SparseInput& s = sparse_inputs[batch];
+        if (s.sparse) {
+          SparseOuter(rows, output_sensitivity[batch]->values.data() + begin + i,
+                      s.indices, s.values, G + i * stride, stride);
+        }
+      }
+    }
+  }
+
+  #pragma omp parallel for
+  for (size_t begin = 0; begin < input_size; begin += block_size) {
+    Tracer::Span span("Linear::Backward inputs", "omp");
+    const size_t count = std::min(block_size, input_size - begin);
+    for (size_t batch = 0; batch < batch_size; ++batch)
+      kernel::Get().Fill(IS + batch * input_size + begin, count, 0.f);
+
+    if (OS) {
+      kernel::Get().MatMul(batch_size, count, output_size, OS, output_size, 1,
+                           &params[begin], stride, IS + begin, input_size);
+    } else {
+      for (size_t batch = 0; batch < batch_size; ++batch) {
+        kernel::Get().MatMul(1, count, output_size,
+                             output_sensitivity[batch]->values.data(),
+                             output_size, 1, &params[begin], stride,
+                             IS + batch * input_size + begin, input_size);
+      }
     }
   }
 }
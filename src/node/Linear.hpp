@@ -2,13 +2,48 @@
 #define LINEAR_H
 
 #include "Node.hpp"
+#include "node/Epilogue.hpp"
 
 class Linear : public Node {
   public:
-    Linear(Node* node, std::vector<size_t> output_sizes);
+    Linear(Node* node, const Shape& output_sizes);
     void Forward(size_t batch_size) override;
     void Backward(size_t batch_size) override;
+    bool BackwardNeedsOutput() const override;
+    size_t GradientSlots() const override { return 1; }
+    size_t Flops() const override { return 2 * input_size * output_size; }
+
+    // Update the output of sample |batch| after the input values at |indices|
+    // changed by |deltas|, instead of computing it again. Only a few columns of
+    // the params are read. The change of each output value is written into
+    // |output_deltas|. The epilogue must not have an activation. See
+    // IncrementalPredictor.hpp.
+    void ForwardDelta(size_t batch,
+                      const std::vector<size_t>& indices,
+                      const std::vector<float>& deltas,
+                      std::vector<float>& output_deltas);
+
+    // The nodes fused into this one. See pass/Fusion.hpp.
+    Epilogue epilogue;
+
+    // Inputs with at most this fraction of nonzero values, like images with a
+    // black background or the output of a Relu, are multiplied by their
+    // nonzero values only. Forward() and the gradient of the params then read
+    // and write only the matching columns of the params. 0 disables it.
+    float sparse_density = 0.1f;
+
   private:
+    // Find the samples sparse enough, and their nonzero values. Return how
+    // many there are.
+    size_t FindSparseInputs(size_t batch_size);
+
+    struct SparseInput {
+      bool sparse = false;
+      std::vector<size_t> indices;
+      std::vector<float> values;
+    };
+    std::vector<SparseInput> sparse_inputs;
+
     size_t input_size;
     size_t output_size;
 };
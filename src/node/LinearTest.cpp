@@ -1,5 +1,7 @@
+#include <cmath>
 #include "Allocator.hpp"
 #include "Model.hpp"
+#include "TensorExpression.hpp"
 #include "gtest/gtest.h"
 #include "node/Input.hpp"
 #include "node/Linear.cuh"
@@ -69,3 +71,42 @@ TEST(Linear, LinearPerformance) {
   Model model(&input, output, examples);
   model.Train(0.01f, 1000);
 }
+
+TEST(Linear, SparseInputs) {
+  // Samples 0 to 2 are sparse, sample 3 is empty, and the others are dense.
+  Input input({60}, 6);
+  for (size_t batch = 0; batch < 6; ++batch) {
+    for (size_t i = 0; i < 60; ++i) {
+      const bool nonzero = batch < 3 ? i % 20 == batch : batch > 3;
+      input.output[batch][i] = nonzero ? std::sin(float(i + 10 * batch)) : 0.f;
+    }
+  }
+  Batch output_sensitivity(6, {37});
+  for (size_t batch = 0; batch < 6; ++batch) {
+    for (size_t i = 0; i < 37; ++i)
+      output_sensitivity[batch][i] = std::cos(float(i + 10 * batch));
+  }
+
+  // The same params, with and without the sparse path.
+  Linear dense(&input, {37});
+  dense.sparse_density = 0.f;
+  Linear sparse(&input, {37});
+  sparse.params = dense.params;
+  for (Linear* linear : {&dense, &sparse}) {
+    linear->AllocateTrainingBuffers();
+    for (size_t batch = 0; batch < 6; ++batch)
+      linear->output_sensitivity[batch] = &output_sensitivity[batch];
+    linear->Forward(6);
+    linear->Backward(6);
+  }
+
+  for (size_t batch = 0; batch < 6; ++batch) {
+    EXPECT_LT((Tensor(dense.output[batch]) - sparse.output[batch]).Error(),
+              1e-8f);
+    EXPECT_LT((Tensor(dense.input_sensitivity[batch]) -
+               sparse.input_sensitivity[batch]).Error(),
+              1e-8f);
+  }
+  EXPECT_LT((dense.params_sensitivity[0] - sparse.params_sensitivity[0]).Error(),
+            1e-8f);
+}
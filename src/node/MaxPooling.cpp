@@ -5,14 +5,12 @@ MaxPooling::MaxPooling(Node* node) {
   Link(node);
 
   // clang-format off
-  output = std::vector<Tensor>(T, Tensor({
+  output = Batch(capacity_, {
     input[0]->sizes[0]/2,
     input[0]->sizes[1]/2,
     input[0]->sizes[2],
-  }));
+  });
   // clang-format on
-
-  InitInternalSensitivity();
 }
 
 void MaxPooling::Forward(size_t batch_size) {
@@ -2,39 +2,53 @@
 #include "Node.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <typeinfo>
+#include "Thread.hpp"
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
 
 //static constexpr float ADAM_b1 = 0.f;
 static constexpr float ADAM_b2 = 0.9f;
 static constexpr float ADAM_epsilon = 1e-4f;
 constexpr size_t Node::T;
 
+static size_t link_generation = 0;
+
 void Node::Update(size_t batch_size, float lambda) {
   InitIfNeeded();
   if (locked)
     return;
   n += 1;
 
-  // Gather params_sensitivity
-  Tensor PS = Tensor(params_sensitivity[0].sizes);
-  for (size_t batch = 0; batch < batch_size; ++batch) {
-    PS += params_sensitivity[batch];
-    params_sensitivity[batch].Fill(0.f);
-  }
-
-  // I am using ADAM optimizer.
+  // I am using ADAM optimizer. The params are split among the threads. Each
+  // one gathers the params_sensitivity of its params from every slot.
   const size_t params_size = params.values.size();
+  const size_t slots = params_sensitivity.size();
+  float* sensitivities = params_sensitivity.data();
+  #pragma omp parallel for
   for (size_t p = 0; p < params_size; ++p) {
+    float PS = 0.f;
+    for (size_t slot = 0; slot < slots; ++slot) {
+      float& ps = sensitivities[slot * params_size + p];
+      PS += ps;
+      ps = 0.f;
+    }
+
     // Update first and second order estimate.
-    //momentum[p] = ADAM_b1 * momentum[p] + (1.f - ADAM_b1) * PS[p];
+    //momentum[p] = ADAM_b1 * momentum[p] + (1.f - ADAM_b1) * PS;
 
     smoothed_squared_gradient[p] = ADAM_b2 * smoothed_squared_gradient[p] +
-                                   (1.f - ADAM_b2) * PS[p] * PS[p];
+                                   (1.f - ADAM_b2) * PS * PS;
 
     // Correct the bias.
     //const float vt = momentum[p];// * (1.f - pow(ADAM_b1, n));
     const float mt = smoothed_squared_gradient[p];// * (1.f - pow(ADAM_b2, n));
 
-    params[p] -= lambda * PS[p] / (std::sqrt(mt) + ADAM_epsilon);
+    params[p] -= lambda * PS / (std::sqrt(mt) + ADAM_epsilon);
     
 
 
@@ -44,38 +58,123 @@ void Node::Update(size_t batch_size, float lambda) {
       //momentum[p] = 0.f;
     //if (std::isnan(smoothed_squared_gradient[p]))
       //smoothed_squared_gradient[p] = 0.f;
-    //if (std::isnan(PS[p]))
-      //PS[p] = 0.f;
+    //if (std::isnan(PS))
+      //PS = 0.f;
   }
 }
 
 // static
 void Node::Link(Node* previous, Node* next) {
   // Make them refer to each other.
+  if (previous->next != next || next->previous != previous)
+    ++link_generation;
   previous->next = next;
   next->previous = previous;
 
-  // Resize in case they are null.
-  previous->output.resize(T);
-  previous->output_sensitivity.resize(T);
-  next->input.resize(T);
-  next->input_sensitivity.resize(T);
-
   // Link for each batch.
-  for (size_t batch = 0; batch < T; ++batch) {
+  next->input.resize(previous->output.size());
+  for (size_t batch = 0; batch < next->input.size(); ++batch)
     next->input[batch] = &(previous->output[batch]);
+
+  // The sensitivities only exist once the training buffers are allocated.
+  previous->output_sensitivity.resize(next->input_sensitivity.size());
+  for (size_t batch = 0; batch < next->input_sensitivity.size(); ++batch)
     previous->output_sensitivity[batch] = &(next->input_sensitivity[batch]);
+}
+
+std::string Node::Name() const {
+  const char* name = typeid(*this).name();
+#ifdef __GNUG__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0) {
+    std::string result = demangled;
+    std::free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+size_t Node::GradientSlots() const {
+  return Thread::Count();
+}
+
+// static
+size_t Node::LinkGeneration() {
+  return link_generation;
+}
+
+// static
+void Node::InvalidatePlans() {
+  ++link_generation;
+}
+
+void Node::AllocateTrainingBuffers() {
+  inference_only = false;
+  InitIfNeeded();
+
+  // Every output is needed by the backward pass. They can't share their
+  // memory anymore, see pass::ShareOutputs().
+  if (AliasesInput()) {
+    if (output.data() != previous->output.data())
+      output = previous->output.Alias();
+  } else if (output.IsAlias()) {
+    output = Batch(capacity_, output[0].sizes);
+  }
+
+  if (params_sensitivity.size() != GradientSlots())
+    params_sensitivity = Batch(GradientSlots(), params.sizes);
+  if (output_sensitivity.size() != capacity_)
+    output_sensitivity.resize(capacity_, nullptr);
+
+  if (previous) {
+    const Shape& input_sizes = previous->output[0].sizes;
+    if (input_sensitivity.size() != capacity_ ||
+        input_sensitivity[0].sizes != input_sizes) {
+      input_sensitivity = Batch(capacity_, input_sizes);
+    }
+    Link(previous, this);
   }
 }
 
-void Node::InitInternalSensitivity() {
-  input_sensitivity = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-  params_sensitivity = std::vector<Tensor>(T, Tensor(params.sizes));
-  output_sensitivity = std::vector<Tensor*>(T, nullptr);
-  Link(previous);
+void Node::SetCapacity(size_t capacity) {
+  if (capacity == 0)
+    throw std::invalid_argument("Node: the capacity must be positive");
+  if (capacity == capacity_)
+    return;
+  capacity_ = capacity;
+
+  if (AliasesInput())
+    output = previous->output.Alias();
+  else
+    output = Batch(capacity, output[0].sizes);
+  if (!output_sensitivity.empty())
+    output_sensitivity.resize(capacity, nullptr);
+  if (!input_sensitivity.empty())
+    input_sensitivity = Batch(capacity, input_sensitivity[0].sizes);
+
+  if (previous && previous->next == this)
+    Link(previous, this);
+  if (next && next->previous == this)
+    Link(this, next);
+}
+
+void Node::InferenceOnly() {
+  inference_only = true;
+  initiated = false;
+  smoothed_squared_gradient = Tensor();
+  momentum = Tensor();
+
+  params_sensitivity = Batch();
+  input_sensitivity = Batch();
+  output_sensitivity = std::vector<Tensor*>();
+  if (previous && previous->next == this)
+    Link(previous, this);
 }
 
 void Node::Link(Node* previous) {
+  capacity_ = previous->capacity_;
   Link(previous, this);
 }
 
@@ -90,9 +189,7 @@ void Node::InitIfNeeded() {
 }
 
 void Node::Clear() {
-  for (size_t batch = 0; batch < T; ++batch) {
-    params_sensitivity[batch].Fill(0.f);
-  }
+  params_sensitivity.Fill(0.f);
   //momentum.Fill(0.f);
   //smoothed_squared_gradient.Fill(0.f);
 }
@@ -138,10 +235,14 @@ void ReverseRange::Apply(void (Node::*f)()) {
 }
 
 void Node::SerializeParams(std::vector<float>& value) {
-  InitIfNeeded();
-
   for (auto& p : params.values)
     value.push_back(p);
+
+  // Without optimizer state, write what a fresh one would contain.
+  if (!initiated) {
+    value.insert(value.end(), 2 * params.values.size(), 0.f);
+    return;
+  }
   for (auto& p : smoothed_squared_gradient.values)
     value.push_back(p);
   for (auto& p : momentum.values)
@@ -149,9 +250,14 @@ void Node::SerializeParams(std::vector<float>& value) {
 }
 
 void Node::DeserializeParams(const std::vector<float>& value, size_t& index) {
-  InitIfNeeded();
   for (auto& p : params.values)
     p = value[index++];
+
+  if (inference_only) {
+    index += 2 * params.values.size();
+    return;
+  }
+  InitIfNeeded();
   for (auto& p : smoothed_squared_gradient.values)
     p = value[index++];
   for (auto& p : momentum.values)
@@ -2,10 +2,13 @@
 #define NODE_H
 
 #include <functional>
+#include <string>
+#include "Batch.hpp"
 #include "Tensor.hpp"
 
 class Node {
  public:
+  // Default number of samples in a batch.
   static constexpr size_t T = 64;
 
   Node() = default;
@@ -16,17 +19,42 @@ class Node {
 
   // Forward step
   std::vector<Tensor*> input;
-  std::vector<Tensor> output;
-
-  // Backward
-  std::vector<Tensor> input_sensitivity;
-  std::vector<Tensor> params_sensitivity;
+  Batch output;
+
+  // How |output| is stored during training, between its use by the next
+  // node's forward pass and the backward pass. See Precision.hpp.
+  Precision precision = Precision::Float32;
+
+  // Backward. Empty until AllocateTrainingBuffers() is called.
+  Batch input_sensitivity;
+  // One slot per thread by default, see Thread.hpp. Backward() accumulates the
+  // gradient of its samples into params_sensitivity[Thread::Index()], and
+  // Update() gathers the slots. See GradientSlots().
+  Batch params_sensitivity;
   std::vector<Tensor*> output_sensitivity;
 
   virtual void Forward(size_t batch_size) = 0;
   virtual void Backward(size_t batch_size) = 0;
   void Update(size_t batch_size, float lambda);
 
+  // What Backward() reads, besides the sensitivities. A node running in place
+  // overwrites its input, see pass/InPlace.hpp.
+  virtual bool BackwardNeedsInput() const { return true; }
+  virtual bool BackwardNeedsOutput() const { return true; }
+  // Whether Forward() works with |output| being the same memory as |input|.
+  virtual bool CanRunInPlace() const { return false; }
+
+  // Number of slots of |params_sensitivity|. A node whose Backward() splits
+  // the params among the threads, instead of the samples, needs only one.
+  virtual size_t GradientSlots() const;
+
+  // Estimated floating point operations of Forward() for one sample. See
+  // Profiler.hpp.
+  virtual size_t Flops() const { return output.sample_size(); }
+
+  // The name of the type of the node, like "Linear".
+  std::string Name() const;
+
   Node* next = nullptr;
   Node* previous = nullptr;
 
@@ -37,16 +65,61 @@ class Node {
 
   static void Link(Node* previous, Node* next);
 
+  // Incremented whenever Link() changes the graph, or InvalidatePlans() is
+  // called. A Plan compiled before is outdated.
+  static size_t LinkGeneration();
+  static void InvalidatePlans();
+
+  // The node computing the output of this one, when fused into it. This node
+  // then doesn't run, and its output is an alias. See pass/Fusion.hpp.
+  Node* fused_into = nullptr;
+
+  // Whether this node writes its output over its input. See pass/InPlace.hpp.
+  bool in_place = false;
+
+  // Whether |output| is an alias of the output of |previous|.
+  bool AliasesInput() const { return fused_into || in_place; }
+
+  // Whether the output is discarded once consumed by the forward pass of
+  // training, and computed again for the backward pass. See
+  // Model::SetCheckpoints().
+  bool recompute = false;
+
+  // Whether running Forward() again gives the same output.
+  virtual bool CanRecompute() const { return true; }
+
+  // Number of samples the buffers have room for. A node gets the capacity of
+  // the node it is built upon, so a whole graph shares the capacity of its
+  // Input.
+  size_t capacity() const { return capacity_; }
+
+  // Resize every buffer to |capacity| samples and relink with the neighbours.
+  // To be applied to every node of a graph, in order. See
+  // Model::SetBatchCapacity().
+  virtual void SetCapacity(size_t capacity);
+
+  // The sensitivities and the optimizer state are only needed for training.
+  // They are allocated by Model::Train, through AllocateTrainingBuffers(). A
+  // network only used for inference never pays for them.
+  void AllocateTrainingBuffers();
+
+  // Release the training buffers. The optimizer state isn't loaded by
+  // DeserializeParams anymore.
+  void InferenceOnly();
+
   void SerializeParams(std::vector<float>& value);
   void DeserializeParams(const std::vector<float>& value, size_t& index);
 
  protected:
+  // Link after |previous|, and take its capacity.
   void Link(Node* previous);
-  void InitInternalSensitivity();
+
+  size_t capacity_ = T;
 
  private:
   void InitIfNeeded();
   bool initiated = false;
+  bool inference_only = false;
   Tensor smoothed_squared_gradient;
   Tensor momentum;
 
@@ -1,25 +1,30 @@
 #include "Noise.hpp"
+#include <algorithm>
 #include <cmath>
-#include <random>
-
-static std::mt19937 rng;
 
 Noise::Noise(Node* node, float sigma) : sigma(sigma) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
 }
 
 void Noise::Forward(size_t batch_size) {
-  std::normal_distribution<float> random(0.0, sigma);
+  const uint64_t current_step = step++;
+  #pragma omp parallel for
   for (size_t batch = 0; batch < batch_size; ++batch) {
     Tensor& O = output[batch];
     Tensor& I = *(input[batch]);
 
+    // The noise is drawn by chunks, so that |O| can be |I|, when running in
+    // place.
+    Random random(key, current_step, batch);
+    float noise[64];
     const size_t size = I.values.size();
-    for (size_t i = 0; i < size; ++i) {
-      O[i] = I[i] + random(rng);
+    for (size_t begin = 0; begin < size; begin += 64) {
+      const size_t count = std::min(size_t(64), size - begin);
+      random.Normal(noise, count, 0.f, sigma);
+      for (size_t i = 0; i < count; ++i)
+        O[begin + i] = I[begin + i] + noise[i];
     }
   }
 }
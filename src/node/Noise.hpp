@@ -1,6 +1,7 @@
 #ifndef NOISE_H
 #define NOISE_H
 
+#include "Random.hpp"
 #include "node/Node.hpp"
 
 class Noise : public Node {
@@ -8,8 +9,17 @@ class Noise : public Node {
   Noise(Node* input, float sigma);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool BackwardNeedsOutput() const override { return false; }
+  bool CanRunInPlace() const override { return true; }
+  bool CanRecompute() const override { return false; }
  private:
   float sigma = 0.f;
+
+  // Sample |batch| of the |step|-th forward pass draws from the substream
+  // (step, batch) of this key.
+  uint64_t key = Random::NewKey();
+  uint64_t step = 0;
 };
 
 #endif /* end of include guard: NOISE_H */
@@ -3,9 +3,7 @@
 Relu::Relu(Node* node) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
 }
 
 void Relu::Forward(size_t batch_size) {
@@ -24,13 +22,15 @@ void Relu::Forward(size_t batch_size) {
 void Relu::Backward(size_t batch_size) {
   #pragma omp parallel for
   for (size_t batch = 0; batch < batch_size; ++batch) {
-    Tensor& I = *(input[batch]);
+    Tensor& O = output[batch];
     Tensor& OS = *(output_sensitivity[batch]);
     Tensor& IS = input_sensitivity[batch];
 
-    const size_t size = I.values.size();
+    // The output is positive exactly when the input is. The input may have
+    // been overwritten when running in place.
+    const size_t size = O.values.size();
     for (size_t i = 0; i < size; ++i) {
-      IS[i] = I[i] > 0.f ? OS[i] : 0.f;
+      IS[i] = O[i] > 0.f ? OS[i] : 0.f;
     }
   }
 }
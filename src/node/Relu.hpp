@@ -8,6 +8,8 @@ class Relu : public Node {
   Relu(Node* input);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool CanRunInPlace() const override { return true; }
 };
 
 #endif /* end of include guard: RELU_H */
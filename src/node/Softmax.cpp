@@ -4,9 +4,7 @@
 
 Softmax::Softmax(Node* node) {
   Link(node);
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
 }
 
 void Softmax::Forward(size_t batch_size) {
@@ -14,7 +12,7 @@ void Softmax::Forward(size_t batch_size) {
   for (size_t batch = 0; batch < batch_size; ++batch) {
     Tensor& O = output[batch];
     Tensor& I = *(input[batch]);
-    StableSoftmax(I.values, O.values);
+    StableSoftmax(I.values.data(), O.values.data(), O.values.size());
   }
 }
 
@@ -4,6 +4,7 @@
 #include "node/Softmax.hpp"
 #include "node/Sigmoid.hpp"
 #include "Model.hpp"
+#include "Random.hpp"
 #include "gtest/gtest.h"
 
 namespace {
@@ -21,6 +22,9 @@ Tensor xor_function(Tensor& input) {
 }  // namespace
 
 TEST(Softmax, Softmax) {
+  // Whether the training converges depends on the random values.
+  Random::SeedGlobal(3);
+
   // Generate examples.
   std::vector<Example> examples;
   for (int i = 0; i < 10000; ++i) {
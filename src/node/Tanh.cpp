@@ -4,8 +4,7 @@
 Tanh::Tanh(Node* node) {
   Link(node);
 
-  output = std::vector<Tensor>(T, Tensor(input[0]->sizes));
-  InitInternalSensitivity();
+  output = Batch(capacity_, input[0]->sizes);
 }
 
 void Tanh::Forward(size_t batch_size) {
@@ -8,6 +8,8 @@ class Tanh : public Node {
   Tanh(Node* input);
   void Forward(size_t batch_size) override;
   void Backward(size_t batch_size) override;
+  bool BackwardNeedsInput() const override { return false; }
+  bool CanRunInPlace() const override { return true; }
 };
 
 #endif /* end of include guard: TANH_H */
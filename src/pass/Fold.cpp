@@ -0,0 +1,62 @@
+#include "pass/Fold.hpp"
+#include "node/BatchNormalization.hpp"
+#include "node/Bias.hpp"
+#include "node/Convolution2D.hpp"
+#include "node/Deconvolution2D.hpp"
+#include "node/Linear.hpp"
+
+namespace pass {
+
+namespace {
+
+// Whether the output of |node| is linear in its params. A fused Bias is, but
+// not an activation.
+bool IsFoldable(Node* node) {
+  if (auto linear = dynamic_cast<Linear*>(node))
+    return linear->epilogue.activation == Epilogue::Activation::None;
+  if (auto convolution = dynamic_cast<Convolution2D*>(node))
+    return convolution->epilogue.activation == Epilogue::Activation::None;
+  return dynamic_cast<Deconvolution2D*>(node) != nullptr;
+}
+
+}  // namespace
+
+size_t FoldBatchNormalization(Node* input, Node* output) {
+  size_t folded = 0;
+  Node* next = nullptr;
+  for (Node* node = input->next; node != output; node = next) {
+    next = node->next;
+    auto normalization = dynamic_cast<BatchNormalization*>(node);
+    if (!normalization)
+      continue;
+
+    Node* previous = node->previous;
+    if (previous->next != node || next->previous != node)
+      continue;
+    Node* bias = dynamic_cast<Bias*>(previous) ? previous : nullptr;
+    Node* producer = bias ? bias->previous : previous;
+    if (producer == input || (bias && producer->next != bias) ||
+        !IsFoldable(producer)) {
+      continue;
+    }
+
+    // The node multiplies its input by a constant.
+    const float scale = normalization->RunningScale();
+    producer->params *= scale;
+    if (bias)
+      bias->params *= scale;
+
+    Node::Link(previous, next);
+    if (next->in_place) {
+      next->output = previous->output.Alias();
+      if (next->next && next->next->previous == next)
+        Node::Link(next, next->next);
+    }
+    ++folded;
+  }
+
+  Node::InvalidatePlans();
+  return folded;
+}
+
+}  // namespace pass
@@ -0,0 +1,21 @@
+#ifndef PASS_FOLD_H
+#define PASS_FOLD_H
+
+#include "node/Node.hpp"
+
+namespace pass {
+
+// For inference only. Remove the BatchNormalization nodes of ]input, output[
+// following a Linear, a Convolution2D or a Deconvolution2D, optionally through
+// a Bias. The scale of their running statistics is folded into the params of
+// those nodes instead. See node/BatchNormalization.hpp.
+//
+// A prediction then costs nothing more than without normalization, and no
+// longer depends on the statistics of its batch. The producer must not have
+// fused an activation: fold before pass::Fuse(). Returns the number of removed
+// nodes.
+size_t FoldBatchNormalization(Node* input, Node* output);
+
+}  // namespace pass
+
+#endif /* end of include guard: PASS_FOLD_H */
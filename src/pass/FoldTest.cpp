@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include "node/BatchNormalization.hpp"
+#include "node/Bias.hpp"
+#include "node/Convolution2D.hpp"
+#include "node/Input.hpp"
+#include "node/Linear.hpp"
+#include "node/Relu.hpp"
+#include "node/Sigmoid.hpp"
+#include "pass/Fold.hpp"
+#include "pass/Fusion.hpp"
+#include "test/TwinModels.hpp"
+
+namespace {
+
+// Input -> Convolution2D -> Bias -> BatchNormalization -> Relu -> Linear ->
+// BatchNormalization -> Sigmoid
+struct Network {
+  Network()
+      : input({5, 5, 2}, 8),
+        convolution(&input, {3, 3}, 2),
+        bias(&convolution),
+        normalization_1(&bias),
+        relu(&normalization_1),
+        linear(&relu, {3}),
+        normalization_2(&linear),
+        sigmoid(&normalization_2) {}
+
+  Input input;
+  Convolution2D convolution;
+  Bias bias;
+  BatchNormalization normalization_1;
+  Relu relu;
+  Linear linear;
+  BatchNormalization normalization_2;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+std::vector<Example> Examples() {
+  std::vector<Example> examples;
+  for (int i = 0; i < 16; ++i) {
+    Tensor input = Tensor::Random({5, 5, 2});
+    input *= 3.f;
+    examples.push_back({input, Tensor::Random({3})});
+  }
+  return examples;
+}
+
+}  // namespace
+
+TEST(Fold, BatchNormalization) {
+  TwinModels<Network> twins(Examples());
+  twins.Train(0.01f, 16, 5);
+
+  // A prediction uses the running statistics once frozen.
+  Network& reference = twins.reference;
+  const Tensor batch_prediction =
+      twins.reference_model.Predict(twins.reference_model.examples[0].input);
+  reference.normalization_1.Freeze();
+  reference.normalization_2.Freeze();
+  const Tensor expected =
+      twins.reference_model.Predict(twins.reference_model.examples[0].input);
+  EXPECT_GT((batch_prediction - expected).Error(), 1e-6);
+  EXPECT_NE(reference.normalization_1.RunningScale(), 1.f);
+
+  Network& folded = twins.network;
+  EXPECT_EQ(pass::FoldBatchNormalization(&folded.input, &folded.sigmoid), 2u);
+  EXPECT_EQ(folded.bias.next, &folded.relu);
+  EXPECT_EQ(folded.relu.previous, &folded.bias);
+  EXPECT_EQ(folded.linear.next, &folded.sigmoid);
+  EXPECT_EQ(folded.sigmoid.previous, &folded.linear);
+
+  EXPECT_TRUE(twins.SamePredictions(1e-10));
+}
+
+// The Bias before the first BatchNormalization is fused into the convolution.
+TEST(Fold, AfterFusedBias) {
+  TwinModels<Network> twins(Examples());
+  twins.Train(0.01f, 16, 5);
+  twins.reference.normalization_1.Freeze();
+  twins.reference.normalization_2.Freeze();
+
+  Network& folded = twins.network;
+  EXPECT_EQ(pass::Fuse(&folded.input, &folded.sigmoid), 1u);
+  EXPECT_EQ(folded.bias.fused_into, &folded.convolution);
+  EXPECT_EQ(pass::FoldBatchNormalization(&folded.input, &folded.sigmoid), 2u);
+  EXPECT_EQ(folded.relu.previous, &folded.bias);
+  EXPECT_EQ(folded.relu.input[0]->values.data(),
+            folded.convolution.output[0].values.data());
+
+  EXPECT_TRUE(twins.SamePredictions(1e-10));
+}
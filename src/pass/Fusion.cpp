@@ -0,0 +1,95 @@
+#include "pass/Fusion.hpp"
+#include "node/Bias.hpp"
+#include "node/Convolution2D.hpp"
+#include "node/Epilogue.hpp"
+#include "node/LeakyRelu.hpp"
+#include "node/Linear.hpp"
+#include "node/Relu.hpp"
+#include "node/Sigmoid.hpp"
+#include "node/Tanh.hpp"
+
+namespace pass {
+
+namespace {
+
+Epilogue* EpilogueOf(Node* node) {
+  if (auto linear = dynamic_cast<Linear*>(node))
+    return &linear->epilogue;
+  if (auto convolution = dynamic_cast<Convolution2D*>(node))
+    return &convolution->epilogue;
+  return nullptr;
+}
+
+Epilogue::Activation ActivationOf(Node* node) {
+  if (dynamic_cast<Relu*>(node))
+    return Epilogue::Activation::Relu;
+  if (dynamic_cast<LeakyRelu*>(node))
+    return Epilogue::Activation::LeakyRelu;
+  if (dynamic_cast<Sigmoid*>(node))
+    return Epilogue::Activation::Sigmoid;
+  if (dynamic_cast<Tanh*>(node))
+    return Epilogue::Activation::Tanh;
+  return Epilogue::Activation::None;
+}
+
+// Make |node| read the values of |producer| instead of computing its own.
+void FuseInto(Node* node, Node* producer, Epilogue* epilogue) {
+  node->fused_into = producer;
+  node->output = producer->output.Alias();
+  if (node->next && node->next->previous == node)
+    Node::Link(node, node->next);
+  epilogue->last = node;
+}
+
+}  // namespace
+
+size_t Fuse(Node* input, Node* output) {
+  size_t fused = 0;
+  for (Node* node = input; node != output;) {
+    node = node->next;
+    Epilogue* epilogue = EpilogueOf(node);
+    if (!epilogue || !epilogue->empty())
+      continue;
+
+    Node* producer = node;
+    while (node != output && node->next->previous == node) {
+      Node* candidate = node->next;
+      if (dynamic_cast<Bias*>(candidate) && !epilogue->bias &&
+          epilogue->activation == Epilogue::Activation::None) {
+        epilogue->bias = candidate;
+      } else if (ActivationOf(candidate) != Epilogue::Activation::None &&
+                 epilogue->activation == Epilogue::Activation::None) {
+        epilogue->activation = ActivationOf(candidate);
+      } else {
+        break;
+      }
+      FuseInto(candidate, producer, epilogue);
+      node = candidate;
+      ++fused;
+    }
+  }
+
+  Node::InvalidatePlans();
+  return fused;
+}
+
+void Unfuse(Node* input, Node* output) {
+  for (Node* node = input; node != output;) {
+    node = node->next;
+    if (Epilogue* epilogue = EpilogueOf(node))
+      *epilogue = Epilogue();
+    if (!node->fused_into)
+      continue;
+    node->fused_into = nullptr;
+    if (node->in_place)
+      node->output = node->previous->output.Alias();
+    else
+      node->output = Batch(node->capacity(), node->output[0].sizes);
+    if (node->next && node->next->previous == node)
+      Node::Link(node, node->next);
+  }
+
+  Node::InvalidatePlans();
+}
+
+}  // namespace pass
@@ -0,0 +1,23 @@
+#ifndef PASS_FUSION_H
+#define PASS_FUSION_H
+
+#include "node/Node.hpp"
+
+// Passes rewriting a graph of nodes, without changing its results.
+namespace pass {
+
+// Fuse the elementwise nodes following a Linear or a Convolution2D of
+// ]input, output] into its epilogue: an optional Bias, then an optional Relu,
+// LeakyRelu, Sigmoid or Tanh. See node/Epilogue.hpp.
+//
+// The activation is then applied while the output of the producer is still in
+// cache, instead of being written and read back by another node. This holds
+// for training too. Returns the number of fused nodes.
+size_t Fuse(Node* input, Node* output);
+
+// Give every fused node of ]input, output] its own output back.
+void Unfuse(Node* input, Node* output);
+
+}  // namespace pass
+
+#endif /* end of include guard: PASS_FUSION_H */
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include "node/Bias.hpp"
+#include "node/Convolution2D.hpp"
+#include "node/Input.hpp"
+#include "node/LeakyRelu.hpp"
+#include "node/Linear.hpp"
+#include "node/Sigmoid.hpp"
+#include "node/Tanh.hpp"
+#include "pass/Fusion.hpp"
+#include "test/TwinModels.hpp"
+
+namespace {
+
+// Input -> Convolution2D -> Bias -> LeakyRelu -> Linear -> Tanh -> Linear ->
+// Sigmoid
+struct Network {
+  Network()
+      : input({6, 6, 2}),
+        convolution(&input, {3, 3}, 2),
+        bias(&convolution),
+        leaky_relu(&bias),
+        linear_1(&leaky_relu, {5}),
+        tanh(&linear_1),
+        linear_2(&tanh, {3}),
+        sigmoid(&linear_2) {}
+
+  Input input;
+  Convolution2D convolution;
+  Bias bias;
+  LeakyRelu leaky_relu;
+  Linear linear_1;
+  Tanh tanh;
+  Linear linear_2;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+}  // namespace
+
+TEST(Fusion, SameResults) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 20; ++i)
+    examples.push_back({Tensor::Random({6, 6, 2}), Tensor::Random({3})});
+
+  TwinModels<Network> twins(examples);
+  Network& fused = twins.network;
+  EXPECT_EQ(pass::Fuse(&fused.input, &fused.sigmoid), 4u);
+  EXPECT_EQ(fused.bias.fused_into, &fused.convolution);
+  EXPECT_EQ(fused.leaky_relu.fused_into, &fused.convolution);
+  EXPECT_EQ(fused.tanh.fused_into, &fused.linear_1);
+  EXPECT_EQ(fused.sigmoid.fused_into, &fused.linear_2);
+
+  // The fused nodes don't have their own output anymore.
+  EXPECT_EQ(fused.sigmoid.output[0].values.data(),
+            fused.linear_2.output[0].values.data());
+
+  EXPECT_TRUE(twins.SamePrediction(examples[0].input, 1e-10));
+
+  // Training follows the same path.
+  twins.Train(0.01f, 20, 5);
+  EXPECT_TRUE(twins.SameParams(1e-4f));
+
+  // Unfusing gives the nodes their output back.
+  pass::Unfuse(&fused.input, &fused.sigmoid);
+  EXPECT_EQ(fused.sigmoid.fused_into, nullptr);
+  EXPECT_NE(fused.sigmoid.output[0].values.data(),
+            fused.linear_2.output[0].values.data());
+  EXPECT_TRUE(twins.SamePrediction(examples[0].input, 1e-6));
+}
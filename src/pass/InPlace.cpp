@@ -0,0 +1,34 @@
+#include "pass/InPlace.hpp"
+
+namespace pass {
+
+size_t RunInPlace(Node* input, Node* output) {
+  size_t in_place = 0;
+  for (Node* node = input; node != output;) {
+    node = node->next;
+    if (node->in_place || node->fused_into || !node->CanRunInPlace())
+      continue;
+
+    // The node whose values would be overwritten.
+    Node* producer = node->previous;
+    while (producer->fused_into)
+      producer = producer->fused_into;
+
+    // The input of the network belongs to the caller.
+    if (producer == input || node->previous->next != node)
+      continue;
+    if (producer->BackwardNeedsOutput() || node->BackwardNeedsInput())
+      continue;
+
+    node->in_place = true;
+    node->output = node->previous->output.Alias();
+    if (node->next && node->next->previous == node)
+      Node::Link(node, node->next);
+    ++in_place;
+  }
+
+  Node::InvalidatePlans();
+  return in_place;
+}
+
+}  // namespace pass
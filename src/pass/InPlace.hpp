@@ -0,0 +1,19 @@
+#ifndef PASS_IN_PLACE_H
+#define PASS_IN_PLACE_H
+
+#include "node/Node.hpp"
+
+namespace pass {
+
+// Make the elementwise nodes of ]input, output] write their output over their
+// input, when nothing needs the input anymore: neither their own Backward(),
+// nor the Backward() of the node computing it. This holds for training too.
+//
+// Relu, LeakyRelu, Sigmoid, Tanh, Bias, Noise and Border support it. Each one
+// saves a whole output, and a copy of it. Returns the number of nodes running
+// in place.
+size_t RunInPlace(Node* input, Node* output);
+
+}  // namespace pass
+
+#endif /* end of include guard: PASS_IN_PLACE_H */
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+
+#include "node/Bias.hpp"
+#include "node/Border.hpp"
+#include "node/Input.hpp"
+#include "node/Linear.hpp"
+#include "node/Noise.hpp"
+#include "node/Relu.hpp"
+#include "node/Sigmoid.hpp"
+#include "pass/InPlace.hpp"
+#include "pass/Memory.hpp"
+#include "test/TwinModels.hpp"
+
+namespace {
+
+// Input -> Relu -> Linear -> Bias -> Relu -> Linear -> Sigmoid -> Noise
+struct Network {
+  Network()
+      : input({4}),
+        relu_1(&input),
+        linear_1(&relu_1, {6}),
+        bias(&linear_1),
+        relu_2(&bias),
+        linear_2(&relu_2, {3}),
+        sigmoid(&linear_2),
+        noise(&sigmoid, 0.f) {}
+
+  Input input;
+  Relu relu_1;
+  Linear linear_1;
+  Bias bias;
+  Relu relu_2;
+  Linear linear_2;
+  Sigmoid sigmoid;
+  Noise noise;
+  Node* output = &noise;
+};
+
+// Input -> Border -> Linear -> Border -> Noise -> Linear -> Sigmoid
+struct Borders {
+  Borders()
+      : input({6, 6}),
+        border_1(&input, 1, 0.f),
+        linear_1(&border_1, {6, 6}),
+        border_2(&linear_1, 1, 0.5f),
+        noise(&border_2, 0.1f),
+        linear_2(&noise, {3}),
+        sigmoid(&linear_2) {}
+
+  Input input;
+  Border border_1;
+  Linear linear_1;
+  Border border_2;
+  Noise noise;
+  Linear linear_2;
+  Sigmoid sigmoid;
+  Node* output = &sigmoid;
+};
+
+}  // namespace
+
+TEST(InPlace, SameResults) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 20; ++i)
+    examples.push_back({Tensor::Random({4}), Tensor::Random({3})});
+
+  TwinModels<Network> twins(examples);
+  Network& in_place = twins.network;
+  EXPECT_EQ(pass::RunInPlace(&in_place.input, &in_place.noise), 3u);
+  // The input belongs to the caller.
+  EXPECT_FALSE(in_place.relu_1.in_place);
+  EXPECT_TRUE(in_place.bias.in_place);
+  EXPECT_TRUE(in_place.relu_2.in_place);
+  EXPECT_TRUE(in_place.sigmoid.in_place);
+  // The Sigmoid needs its output for the backward pass.
+  EXPECT_FALSE(in_place.noise.in_place);
+  EXPECT_EQ(in_place.relu_2.output.data(), in_place.linear_1.output.data());
+
+  twins.Train(0.01f, 20, 5);
+  EXPECT_TRUE(twins.SameParams());
+  EXPECT_TRUE(twins.SamePrediction(examples[0].input));
+
+  // The in place nodes keep aliasing their input once the outputs are shared.
+  twins.model.InferenceOnly();
+  EXPECT_EQ(in_place.relu_2.output.data(), in_place.linear_1.output.data());
+  EXPECT_TRUE(twins.SamePrediction(examples[1].input));
+}
+
+// Border and Noise overwrite their input. Noise draws the same values as in
+// the reference.
+TEST(InPlace, BorderAndNoise) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 20; ++i)
+    examples.push_back({Tensor::Random({6, 6}), Tensor::Random({3})});
+
+  TwinModels<Borders> twins(examples);
+  Borders& in_place = twins.network;
+  EXPECT_EQ(pass::RunInPlace(&in_place.input, &in_place.sigmoid), 3u);
+  EXPECT_FALSE(in_place.border_1.in_place);
+  EXPECT_TRUE(in_place.border_2.in_place);
+  EXPECT_TRUE(in_place.noise.in_place);
+  EXPECT_TRUE(in_place.sigmoid.in_place);
+  EXPECT_EQ(in_place.noise.output.data(), in_place.linear_1.output.data());
+
+  twins.Train(0.01f, 20, 5);
+  EXPECT_TRUE(twins.SameParams());
+  EXPECT_TRUE(twins.SamePredictions());
+}
@@ -0,0 +1,44 @@
+#include "pass/Memory.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace pass {
+
+SharedOutputs ShareOutputs(Node* input, Node* output) {
+  // The nodes owning an output, in order. The others alias the output of the
+  // node before them.
+  std::vector<Node*> writers;
+  for (Node* node = input; node != output;) {
+    node = node->next;
+    if (!node->AliasesInput())
+      writers.push_back(node);
+  }
+
+  size_t sizes[2] = {0, 0};
+  for (size_t i = 0; i < writers.size(); ++i) {
+    const Batch& batch = writers[i]->output;
+    sizes[i % 2] = std::max(sizes[i % 2], batch.size() * batch.sample_size());
+  }
+
+  SharedOutputs shared;
+  for (size_t i = 0; i < 2; ++i)
+    shared.buffers[i] = Storage::Uninitialized(sizes[i]);
+
+  for (size_t i = 0; i < writers.size(); ++i) {
+    Node* node = writers[i];
+    node->output = Batch::Wrap(shared.buffers[i % 2].data(),
+                               node->output.size(), node->output[0].sizes);
+  }
+
+  for (Node* node = input; node != output;) {
+    node = node->next;
+    if (node->AliasesInput())
+      node->output = node->previous->output.Alias();
+    if (node->previous->next == node)
+      Node::Link(node->previous, node);
+  }
+
+  return shared;
+}
+
+}  // namespace pass
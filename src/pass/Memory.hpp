@@ -0,0 +1,35 @@
+#ifndef PASS_MEMORY_H
+#define PASS_MEMORY_H
+
+#include "Storage.hpp"
+#include "node/Node.hpp"
+
+namespace pass {
+
+// The memory holding the outputs of a graph, see ShareOutputs().
+class SharedOutputs {
+ public:
+  // Number of floats.
+  size_t size() const { return buffers[0].size() + buffers[1].size(); }
+
+ private:
+  friend SharedOutputs ShareOutputs(Node* input, Node* output);
+  Storage buffers[2];
+};
+
+// For inference only. A node only reads the output of the one before it, so
+// the outputs of ]input, output] are placed in turn into two buffers, each one
+// as big as its biggest output. Fused and in place nodes keep aliasing the
+// output before them. A deep network runs in the memory of its two biggest
+// layers, which also stay in cache.
+//
+// The output of a node is then only valid until the node after the next one
+// runs. The result of the network stays valid until it runs again. Training
+// gives every node its own output back.
+//
+// The returned buffers must be kept as long as the graph is used this way.
+SharedOutputs ShareOutputs(Node* input, Node* output);
+
+}  // namespace pass
+
+#endif /* end of include guard: PASS_MEMORY_H */
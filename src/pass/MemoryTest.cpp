@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include "Allocator.hpp"
+#include "Model.hpp"
+#include "TensorExpression.hpp"
+#include "pass/Fusion.hpp"
+#include "pass/Memory.hpp"
+
+TEST(Memory, ShareOutputs) {
+  std::vector<Example> examples;
+  for (int i = 0; i < 10; ++i)
+    examples.push_back({Tensor::Random({8}), Tensor::Random({4})});
+
+  // A decoder-like chain of 8 nodes.
+  Allocator a;
+  Node* input = a.Input({8});
+  Node* x = input;
+  for (size_t size : {32, 64, 32, 4})
+    x = a.Relu(a.Linear(x, {size}));
+  Node* output = x;
+
+  Model model(input, output, examples);
+  model.Train(0.01f, 10);
+  std::vector<Tensor> expected;
+  for (auto& example : examples)
+    expected.push_back(model.Predict(example.input));
+
+  model.InferenceOnly(4);
+  Node* first = input->next;
+  Node* third = first->next->next;
+  EXPECT_EQ(first->output.data(), third->output.data());
+  EXPECT_NE(first->output.data(), first->next->output.data());
+  for (size_t i = 0; i < examples.size(); ++i)
+    EXPECT_EQ(Tensor(model.Predict(examples[i].input)), expected[i]);
+
+  // Fused nodes keep aliasing the node they are fused into.
+  pass::Fuse(input, output);
+  auto shared = pass::ShareOutputs(input, output);
+  EXPECT_EQ(shared.size(), 4 * (64 + 32));
+  EXPECT_EQ(first->next->output.data(), first->output.data());
+  for (size_t i = 0; i < examples.size(); ++i)
+    EXPECT_EQ(Tensor(model.Predict(examples[i].input)), expected[i]);
+
+  // Training gives every node its own output back.
+  model.Train(0.01f, 10);
+  EXPECT_NE(first->output.data(), third->output.data());
+  EXPECT_EQ(first->next->output.data(), first->output.data());
+  EXPECT_FALSE(first->output.IsAlias());
+}
@@ -0,0 +1,88 @@
+#ifndef TEST_TWIN_MODELS_H
+#define TEST_TWIN_MODELS_H
+
+#include <cmath>
+#include <vector>
+#include "Model.hpp"
+#include "Random.hpp"
+#include "TensorExpression.hpp"
+#include "gtest/gtest.h"
+
+// Two instances of the same network with the same params, for the tests
+// checking that a pass or an option doesn't change the results. The test
+// transforms |network|, then compares |model| to |reference_model|.
+//
+// |Network| builds its nodes in its constructor. It has an |input| node, and an
+// |output| pointer to its last node. Both instances are built from the same
+// global seed, so that their Dropout and Noise nodes draw the same values too.
+template <class Network>
+struct TwinModels {
+  explicit TwinModels(const std::vector<Example>& examples = {})
+      : reference_model(&reference.input, reference.output, examples),
+        model(&network.input, network.output, examples) {
+    model.DeserializeParams(reference_model.SerializeParams());
+  }
+
+  // Train both models |times| times.
+  void Train(float lambda, size_t iterations, size_t times = 1) {
+    for (size_t i = 0; i < times; ++i) {
+      reference_model.Train(lambda, iterations);
+      model.Train(lambda, iterations);
+    }
+  }
+
+  // Whether both models predict the same output for |input|, up to a squared
+  // error of |tolerance|.
+  ::testing::AssertionResult SamePrediction(const TensorView& input,
+                                            float tolerance = 0.f) {
+    const Tensor expected = reference_model.Predict(input);
+    const Tensor actual = model.Predict(input);
+    const float error = (expected - actual).Error();
+    if (error <= tolerance)
+      return ::testing::AssertionSuccess();
+    return ::testing::AssertionFailure() << "squared error: " << error;
+  }
+
+  // The same, for the input of every example.
+  ::testing::AssertionResult SamePredictions(float tolerance = 0.f) {
+    for (size_t i = 0; i < reference_model.examples.size(); ++i) {
+      auto result =
+          SamePrediction(reference_model.examples[i].input, tolerance);
+      if (!result)
+        return result << ", example " << i;
+    }
+    return ::testing::AssertionSuccess();
+  }
+
+  // Whether both models have the same params, up to |tolerance| each.
+  ::testing::AssertionResult SameParams(float tolerance = 0.f) {
+    const std::vector<float> expected = reference_model.SerializeParams();
+    const std::vector<float> actual = model.SerializeParams();
+    if (expected.size() != actual.size()) {
+      return ::testing::AssertionFailure()
+             << actual.size() << " params instead of " << expected.size();
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+      if (!(std::abs(expected[i] - actual[i]) <= tolerance)) {
+        return ::testing::AssertionFailure()
+               << "param " << i << ": " << actual[i] << " instead of "
+               << expected[i];
+      }
+    }
+    return ::testing::AssertionSuccess();
+  }
+
+  // Restart the global generator before building each network.
+  struct Seed {
+    Seed() { Random::SeedGlobal(1); }
+  };
+
+  Seed reference_seed;
+  Network reference;
+  Seed seed;
+  Network network;
+  Model reference_model;
+  Model model;
+};
+
+#endif /* end of include guard: TEST_TWIN_MODELS_H */
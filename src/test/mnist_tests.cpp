@@ -375,8 +375,9 @@ TEST(MNIST, WGAN) {
         generated.insert(generated.end(), generator_output->output.begin(),
                          generator_output->output.end());
 
-        auto preview = generator_output->output;
-        preview.resize(examples_reference.size());
+        std::vector<TensorView> preview(
+            generator_output->output.begin(),
+            generator_output->output.begin() + examples_reference.size());
         std::ofstream("live.pgm")
             << image_PGM(Tensor::Merge(preview), -1.0, 1.0);
       }
@@ -1,10 +1,5 @@
 #include "util.hpp"
 
-size_t Multiply(const std::vector<size_t>& v) {
-  size_t ret = 1;
-  for(const size_t i : v) {
-    ret *= i;
-  }
-  return ret;
+size_t Multiply(const Shape& shape) {
+  return shape.Elements();
 }
-
@@ -1,8 +1,8 @@
 #ifndef UTIL_H
 #define UTIL_H
 
-#include <vector>
+#include "Shape.hpp"
 
-size_t Multiply(const std::vector<size_t>&);
+size_t Multiply(const Shape&);
 
 #endif /* end of include guard: UTIL_H */
@@ -1,19 +1,19 @@
 #include "util/stable_softmax.hpp"
+#include <algorithm>
 #include <cmath>
 
-void StableSoftmax(const std::vector<float>& input,
-                   std::vector<float>& output) {
+void StableSoftmax(const float* input, float* output, std::size_t size) {
   float best = input[0];
-  for (float v : input)
-    best = std::max(best, v);
+  for (size_t i = 0; i < size; ++i)
+    best = std::max(best, input[i]);
 
-  for (size_t i = 0; i < output.size(); ++i)
+  for (size_t i = 0; i < size; ++i)
     output[i] = exp(input[i] - best);
 
   // Normalize probability vector.
   float sum = 0.f;
-  for (auto& v : output)
-    sum += v;
-  for (auto& v : output)
-    v /= sum;
+  for (size_t i = 0; i < size; ++i)
+    sum += output[i];
+  for (size_t i = 0; i < size; ++i)
+    output[i] /= sum;
 }
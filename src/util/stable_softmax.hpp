@@ -1,2 +1,2 @@
-#include <vector>
-void StableSoftmax(const std::vector<float>& input, std::vector<float>& output);
+#include <cstddef>
+void StableSoftmax(const float* input, float* output, std::size_t size);